@@ -3,17 +3,24 @@ from setuptools import setup
 from pybind11.setup_helpers import Pybind11Extension, build_ext
 from pybind11 import get_include
 import os
+import sys
 
 # 查找所有 C++ 源文件（如果有子目录，修改路径）
 cpp_sources = glob.glob("src/*.cpp", recursive=True)
 
+# 紧凑模式：设置环境变量 GRAPHWORK_COMPACT=1 后以 float32 权重与花费编译
+define_macros = [('EXAMPLE_MACRO', '1')]
+if os.environ.get("GRAPHWORK_COMPACT", "0") not in ("", "0"):
+    define_macros.append(('GRAPHWORK_COMPACT', '1'))
+
 # 定义 Pybind11 扩展模块
 ext_modules = [
     Pybind11Extension(
         "graphwork",  # C++ 扩展模块名称
         cpp_sources,  # 使用 C++ 源文件
-        define_macros=[('EXAMPLE_MACRO', '1')],  # 可选参数，例如定义宏
+        define_macros=define_macros,  # 可选参数，例如定义宏
         include_dirs=["src", get_include()],  # 确保编译器能找到头文件
+        libraries=["rt"] if sys.platform.startswith("linux") else [],  # 共享内存 shm_open
     ),
 ]
 
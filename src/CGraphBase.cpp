@@ -3,164 +3,512 @@
 // 基础操作 ---------------------------------------------------------------------------------------
 
 
-// 加边
-void CGraph::basic_add_edge(
-	const int o, const int d,
-	const unordered_map<string, double> attribute_dict)
+// 获取或分配内部索引
+int CGraph::intern_node(
+	int node)
 {
-	// 节点初始化（保留原有属性）
-	if (!m_node_map.count(o)) m_node_map[o] = {};
-	if (!m_node_map.count(d)) m_node_map[d] = {};
+	thaw();
+
+	auto it = node_index.find(node);
+	if (it != node_index.end()) return it->second;
+
+	// 新节点：追加到各按内部索引排列的容器
+	int u = static_cast<int>(node_ids.size());
+	node_index.emplace(node, u);
+	node_ids.push_back(node);
+	m_node_map.emplace_back();
+	G.emplace_back();
+	in_edges.emplace_back();
+	if (!node_x.empty()) {
+		node_x.push_back(numeric_limits<double>::quiet_NaN());
+		node_y.push_back(numeric_limits<double>::quiet_NaN());
+	}
+	return u;
+}
+
+
+// 原始编号转内部索引
+int CGraph::find_node(
+	int node) const
+{
+	// 映射状态：在图像的有序编号表上二分查找
+	if (image.active) {
+		auto it = lower_bound(image.sorted_ids.begin(), image.sorted_ids.end(), node);
+		if (it == image.sorted_ids.end() || *it != node) return -1;
+		return image.sorted_index[it - image.sorted_ids.begin()];
+	}
+
+	auto it = node_index.find(node);
+	return it == node_index.end() ? -1 : it->second;
+}
+
+
+// 原始编号列表转内部索引
+vector<int> CGraph::find_nodes(
+	const vector<int>& nodes) const
+{
+	vector<int> result;
+	result.reserve(nodes.size());
+	for (int node : nodes) {
+		int u = find_node(node);
+		if (u != -1) result.push_back(u);
+	}
+	return result;
+}
+
+
+// 判断是否为形心点
+bool CGraph::is_centroid(
+	int u) const
+{
+	if (image.active) return image.centroid_flag[u] != 0;
+
+	auto attr_it = m_node_map[u].find("centroid_");
+	return attr_it != m_node_map[u].end() && attr_it->second == 1;
+}
+
+
+// 由映射图像重建可变结构
+void CGraph::thaw()
+{
+	if (!image.active) return;
+	GraphImage img = move(image);
+	image = GraphImage();
+
+	// 1.节点表与形心标记
+	int num_nodes = static_cast<int>(node_ids.size());
+	node_index.reserve(num_nodes);
+	for (int u = 0; u < num_nodes; ++u) {
+		node_index.emplace(node_ids[u], u);
+	}
+	m_node_map.resize(num_nodes);
+	G.resize(num_nodes);
+	in_edges.resize(num_nodes);
+	for (int u = 0; u < num_nodes; ++u) {
+		if (img.centroid_flag[u]) m_node_map[u]["centroid_"] = 1;
+	}
+
+	// 2.形心边：加载时已写入边表和形心容器，这里只补反向索引
+	for (size_t e = 0; e < edge_from.size(); ++e) {
+		if (edge_to[e] != -1) in_edges[edge_to[e]].push_back(static_cast<int>(e));
+	}
+
+	// 3.非形心边：按正向 CSR 重建，属性按存在位图写回（字段出现数加载时已恢复）
+	edge_from.reserve(edge_from.size() + img.out_target.size());
+	edge_to.reserve(edge_to.size() + img.out_target.size());
+	for (int u = 0; u < num_nodes; ++u) {
+		G[u].reserve(img.out_offset[u + 1] - img.out_offset[u]);
+		for (int pos = img.out_offset[u]; pos < img.out_offset[u + 1]; ++pos) {
+			int v = img.out_target[pos];
+			int e = new_edge(u, v);
+			G[u][v] = e;
+			in_edges[v].push_back(e);
+
+			for (size_t f = 0; f < img.out_present.size(); ++f) {
+				if (img.out_present[f].empty() || !((img.out_present[f][pos >> 6] >> (pos & 63)) & 1)) continue;
+				edge_attr.values[f][e] = img.out_weight[f][pos];
+				edge_attr.present[f][e >> 6] |= uint64_t(1) << (e & 63);
+			}
+		}
+	}
+}
+
+
+// 节点是否有坐标
+bool CGraph::has_coord(
+	int u) const
+{
+	return u < static_cast<int>(node_x.size()) && !std::isnan(node_x[u]) && !std::isnan(node_y[u]);
+}
+
+
+// 按新顺序重排内部索引
+void CGraph::permute_nodes(
+	const vector<int>& order)
+{
+	thaw();
+
+	int num_nodes = static_cast<int>(node_ids.size());
+	if (static_cast<int>(order.size()) != num_nodes) {
+		throw runtime_error("node order must cover all " + to_string(num_nodes) + " nodes");
+	}
+	vector<int> rank(num_nodes, -1); // 旧索引 -> 新索引
+	for (int i = 0; i < num_nodes; ++i) {
+		int u = order[i];
+		if (u < 0 || u >= num_nodes || rank[u] != -1) {
+			throw runtime_error("node order is not a permutation");
+		}
+		rank[u] = i;
+	}
+
+	// 1.按内部索引排列的容器
+	auto permute = [&](auto& values) {
+		using Values = typename std::remove_reference<decltype(values)>::type;
+		Values result(values.size());
+		for (int i = 0; i < num_nodes; ++i) {
+			result[i] = move(values[order[i]]);
+		}
+		values = move(result);
+	};
+	permute(node_ids);
+	permute(m_node_map);
+	permute(G);
+	permute(in_edges);
+	if (!node_x.empty()) {
+		permute(node_x);
+		permute(node_y);
+	}
+	for (int i = 0; i < num_nodes; ++i) {
+		node_index[node_ids[i]] = i;
+	}
+
+	// 2.邻接的终点、边表端点
+	for (auto& row : G) {
+		unordered_map<int, int> remapped;
+		remapped.reserve(row.size());
+		for (const auto& edge : row) {
+			remapped.emplace(rank[edge.first], edge.second);
+		}
+		row = move(remapped);
+	}
+	auto remap_centroid = [&](CentroidGraph& graph) {
+		CentroidGraph remapped;
+		remapped.reserve(graph.size());
+		for (auto& item : graph) {
+			auto& row = remapped[rank[item.first]];
+			row.reserve(item.second.size());
+			for (const auto& edge : item.second) {
+				row.emplace(rank[edge.first], edge.second);
+			}
+		}
+		graph = move(remapped);
+	};
+	remap_centroid(m_centroid_start_map);
+	remap_centroid(m_centroid_end_map);
+	for (size_t e = 0; e < edge_from.size(); ++e) {
+		if (edge_to[e] == -1) continue; // 已回收的边号
+		edge_from[e] = rank[edge_from[e]];
+		edge_to[e] = rank[edge_to[e]];
+	}
+	G_temp.clear();
+
+	// 3.内部索引整体变化，快照需整体重建
+	graph_version++;
+	layout_version++;
+	vector<EdgeEdit>().swap(edge_log);
+	edge_log_enabled = false;
+}
+
+
+// 分配边号
+int CGraph::new_edge(
+	int o, int d)
+{
+	int e;
+	if (!free_edges.empty()) {
+		e = free_edges.back();
+		free_edges.pop_back();
+		edge_from[e] = o;
+		edge_to[e] = d;
+		return e;
+	}
+
+	e = static_cast<int>(edge_from.size());
+	edge_from.push_back(o);
+	edge_to.push_back(d);
+
+	// 列容量不足时整体扩容
+	if (e >= edge_attr.num_slots) {
+		edge_attr.num_slots = max(64, edge_attr.num_slots * 2);
+		for (size_t f = 0; f < edge_attr.values.size(); ++f) {
+			edge_attr.values[f].resize(edge_attr.num_slots);
+			edge_attr.present[f].resize(edge_attr.num_slots / 64);
+		}
+	}
+	return e;
+}
+
+
+// 查找边号
+int CGraph::find_edge(
+	int o, int d) const
+{
+	// 边所在容器由两端的形心属性决定：起点为形心点 -> 起点容器，终点为形心点 -> 终点容器，否则 G
+	auto lookup = [](const CentroidGraph& container, int key1, int key2) {
+		auto it = container.find(key1);
+		if (it == container.end()) return -1;
+		auto edge_it = it->second.find(key2);
+		return edge_it == it->second.end() ? -1 : edge_it->second;
+	};
+
+	bool is_o_centroid = is_centroid(o);
+	bool is_d_centroid = is_centroid(d);
+	if (!is_o_centroid && !is_d_centroid) {
+		auto it = G[o].find(d);
+		return it == G[o].end() ? -1 : it->second;
+	}
+
+	// 起点后设为形心点时，指向形心点的出边仍只在终点容器中
+	int e = is_o_centroid ? lookup(m_centroid_start_map, o, d) : -1;
+	if (e == -1 && is_d_centroid) e = lookup(m_centroid_end_map, d, o);
+	return e;
+}
+
+
+// 回收边号
+void CGraph::release_edge(
+	int e)
+{
+	for (size_t f = 0; f < edge_attr.values.size(); ++f) {
+		if (edge_attr.has(f, e)) {
+			edge_attr.present[f][e >> 6] &= ~(uint64_t(1) << (e & 63));
+			edge_attr.count[f]--;
+		}
+	}
+	edge_from[e] = -1;
+	edge_to[e] = -1;
+	free_edges.push_back(e);
+}
+
+
+// 获取或新建字段列
+int CGraph::intern_field(
+	const string& name)
+{
+	auto it = edge_attr.field_index.find(name);
+	if (it != edge_attr.field_index.end()) return it->second;
+
+	int f = static_cast<int>(edge_attr.field_names.size());
+	edge_attr.field_index.emplace(name, f);
+	edge_attr.field_names.push_back(name);
+	edge_attr.values.emplace_back(edge_attr.num_slots, 0.0);
+	edge_attr.present.emplace_back(edge_attr.num_slots / 64, 0);
+	edge_attr.count.push_back(0);
+	return f;
+}
+
+
+// 设置边属性
+void CGraph::set_edge_attr(
+	int e, int f,
+	double value)
+{
+	if (!edge_attr.has(f, e)) {
+		edge_attr.present[f][e >> 6] |= uint64_t(1) << (e & 63);
+		edge_attr.count[f]++;
+	}
+	edge_attr.values[f][e] = value;
+}
+
+
+// 读取边权重
+double CGraph::get_edge_weight(
+	int e, int f) const
+{
+	return edge_attr.get(f, e, 1.0);
+}
+
+
+// 读取边的全部属性
+EdgeAttr CGraph::get_edge_attrs(
+	int e) const
+{
+	EdgeAttr attrs;
+	for (size_t f = 0; f < edge_attr.field_names.size(); ++f) {
+		if (edge_attr.has(f, e)) {
+			attrs[edge_attr.field_names[f]] = edge_attr.values[f][e];
+		}
+	}
+	return attrs;
+}
+
+
+// 字段出现数
+unordered_map<string, int> CGraph::field_freq() const
+{
+	unordered_map<string, int> freq;
+	for (size_t f = 0; f < edge_attr.field_names.size(); ++f) {
+		if (edge_attr.count[f] > 0) freq[edge_attr.field_names[f]] = edge_attr.count[f];
+	}
+	return freq;
+}
+
+
+// 全勤字段序列
+vector<string> CGraph::field_vec() const
+{
+	vector<string> fields;
+	for (size_t f = 0; f < edge_attr.field_names.size(); ++f) {
+		if (number_link > 0 && edge_attr.count[f] == number_link) fields.push_back(edge_attr.field_names[f]);
+	}
+	return fields;
+}
+
+
+// 挂接一条新边
+int CGraph::basic_link_edge(
+	int o, int d)
+{
+	thaw();
 
 	// 检查边是否存在
-	bool is_new_edge = node_out_list[o].insert(d).second;
-	if (!is_new_edge) return;  // 边已存在，直接返回
-	
-	// 判断形心属性
-	auto& o_node = m_node_map[o];
-	auto& d_node = m_node_map[d];
-	bool is_o_centroid = o_node.count("centroid_") && o_node.at("centroid_") == 1;
-	bool is_d_centroid = d_node.count("centroid_") && d_node.at("centroid_") == 1;
+	if (find_edge(o, d) != -1) return -1;  // 边已存在，直接返回
 
+	int e = new_edge(o, d);
+	in_edges[d].push_back(e);
+
+	// 判断形心属性
+	bool is_o_centroid = is_centroid(o);
+	bool is_d_centroid = is_centroid(d);
 
 	// 根据节点的形心属性决定加边逻辑
-	if (m_node_map[o]["centroid_"] == 1 && m_node_map[d]["centroid_"] == 1) {
-		m_centroid_start_map[o][d] = attribute_dict;
-		m_centroid_end_map[d][o] = attribute_dict;
-		
+	if (is_o_centroid && is_d_centroid) {
+		m_centroid_start_map[o][d] = e;
+		m_centroid_end_map[d][o] = e;
 	}
-	else if (m_node_map[o]["centroid_"] == 1) {
+	else if (is_o_centroid) {
 		// 如果起点是形心点
-		m_centroid_start_map[o][d] = attribute_dict;
-		
+		m_centroid_start_map[o][d] = e;
 	}
-	else if (m_node_map[d]["centroid_"] == 1) {
+	else if (is_d_centroid) {
 		// 如果终点是形心点
-		m_centroid_end_map[d][o] = attribute_dict;
+		m_centroid_end_map[d][o] = e;
 	}
 	else {
 		// 非形心边
-		G[o][d] = attribute_dict;
-		G[d];
+		G[o][d] = e;
+		log_edge_edit(o, d, e, false);
 	}
 
-	node_in_list[d].emplace(o);
-	node_out_list[o].emplace(d);
 	// 更新边的计数
 	number_link += 1;
+	graph_version++;
+	return e;
+}
 
-	// 遍历所有字段并更新 field_freq 和 full_field_map
-	for (const auto& field : attribute_dict) {
-		const string& field_name = field.first;
 
-		// 更新 field_freq
-		if (field_freq.find(field_name) == field_freq.end()) {
-			// 新字段，初始化
-			field_freq[field_name] = 1;
-		}
-		else {
-			// 字段已存在，值加 1
-			field_freq[field_name] += 1;
-		}
+// 记录非形心边增删
+void CGraph::log_edge_edit(
+	int o, int d,
+	int e,
+	bool removed)
+{
+	if (!edge_log_enabled) return;
 
-		// 如果该字段的值 / number_link == 1，说明该字段已完全出现
-		if (field_freq[field_name] / number_link == 1) {
-			// 查找 field_name 在 field_vec 中的位置
-			auto it = find(field_vec.begin(), field_vec.end(), field_name);
-			if (it == field_vec.end()) {
-				// 如果没有找到该字段，说明是新字段，添加到 field_vec 中
-				field_vec.push_back(field_name);
-				// 在 full_field_map 中新增一个 unordered_map
-				full_field_map.push_back(unordered_map<int, vector<pair<int, double>>>());
-				full_field_reverse_map.push_back(unordered_map<int, vector<pair<int, double>>>());
-				// 获取新增字段的位置（索引）
-				it = find(field_vec.begin(), field_vec.end(), field_name);
-			}
+	// 记录超过边数的四分之一时，整体重建快照比回放更划算
+	if (edge_log.size() >= max<size_t>(4096, number_link / 4)) {
+		vector<EdgeEdit>().swap(edge_log);
+		edge_log_enabled = false;
+		layout_version++;
+		return;
+	}
+	edge_log.push_back({ o, d, e, removed });
+}
 
-			// 获取字段在 field_vec 中的位置
-			int field_index = distance(field_vec.begin(), it);
 
-			// 更新 full_field_map 中对应位置的 unordered_map
-			full_field_map[field_index][o].push_back({ d, field.second });
+// 加边
+void CGraph::basic_add_edge(
+	const int o_, const int d_,
+	const unordered_map<string, double>& attribute_dict)
+{
+	// 节点初始化（保留原有属性）
+	int o = intern_node(o_);
+	int d = intern_node(d_);
 
-			// 更新 full_field_reserve_map 中对应位置的 unordered_map（同步更新）
-			full_field_reverse_map[field_index][d].push_back({ o, field.second });
-		}
-	}
+	int e = basic_link_edge(o, d);
+	if (e == -1) return;
 
+	// 写入属性列
+	for (const auto& field : attribute_dict) {
+		set_edge_attr(e, intern_field(field.first), field.second);
+	}
 }
 
 
 // 删边
 void CGraph::basic_remove_edge(
-	const int o, const int d) 
+	const int o_, const int d_) 
 {
-	int edge_removed = 0;
+	thaw();
 
-	// 定义删除函数模板
-	auto erase_edge = [&edge_removed](auto& container, int key1, int key2) {
-		auto it = container.find(key1);
-		if (it != container.end() && it->second.erase(key2)) {
-			edge_removed++;
-			if (it->second.empty()) container.erase(it);
-		}
-	};
+	int o = find_node(o_);
+	int d = find_node(d_);
+	if (o == -1 || d == -1) return;
+
+	int edge_id = -1;
 
 	// 删除普通边
-	erase_edge(G, o, d);
-	// 删除形心起点边
+	auto g_it = G[o].find(d);
+	if (g_it != G[o].end()) {
+		edge_id = g_it->second;
+		G[o].erase(g_it);
+		log_edge_edit(o, d, edge_id, true);
+	}
+
+	// 删除形心起点边、形心终点边（注意参数顺序）
+	auto erase_edge = [&edge_id](CentroidGraph& container, int key1, int key2) {
+		auto it = container.find(key1);
+		if (it == container.end()) return;
+		auto edge_it = it->second.find(key2);
+		if (edge_it == it->second.end()) return;
+		edge_id = edge_it->second;
+		it->second.erase(edge_it);
+		if (it->second.empty()) container.erase(it);
+	};
 	erase_edge(m_centroid_start_map, o, d);
-	// 删除形心终点边（注意参数顺序）
 	erase_edge(m_centroid_end_map, d, o);
 
-	// 更新邻接表
-	if (node_in_list[d].erase(o) && node_in_list[d].empty()) {
-		node_in_list.erase(d);
+	// 更新计数器，从反向索引移除，回收边号
+	if (edge_id != -1) {
+		auto& in = in_edges[d];
+		auto in_it = find(in.begin(), in.end(), edge_id);
+		*in_it = in.back();
+		in.pop_back();
+		release_edge(edge_id);
+		number_link = max(0, number_link - 1);
+		graph_version++;
 	}
-	if (node_out_list[o].erase(d) && node_out_list[o].empty()) {
-		node_out_list.erase(o);
-	}
-
-
-	// 更新计数器
-	if (edge_removed > 0) number_link = max(0, number_link - 1);
 }
 
 
 // 设置形心点
 void CGraph::basic_set_centroid(
-	int o)
+	int o_)
 {
+	thaw();
+
 	// 检查节点是否存在
-	if (!m_node_map.count(o)) {
-		py::print("Error: Node", o, "does not exist");
+	int o = find_node(o_);
+	if (o == -1) {
+		py::print("Error: Node", o_, "does not exist");
 		return;
 	}
 
 	// 若已是行星点则跳过
-	auto& node_attr = m_node_map[o];
-	if (node_attr.count("centroid_") && node_attr["centroid_"] == 1) {
-		py::print("Warning: Node", o, "is already a centroid");
+	if (is_centroid(o)) {
+		py::print("Warning: Node", o_, "is already a centroid");
 		return;
 	}
 
-	// 标记为行星点
-	node_attr["centroid_"] = 1;
+	// 标记为行星点（边在普通图与形心容器间迁移，快照需整体重建）
+	m_node_map[o]["centroid_"] = 1;
+	graph_version++;
+	layout_version++;
+	vector<EdgeEdit>().swap(edge_log);
+	edge_log_enabled = false;
 
 	// 迁移出边到行星起点容器
-	if (node_out_list.count(o)) {
+	if (!G[o].empty()) {
 		m_centroid_start_map[o] = move(G[o]); // 移动语义提升性能
-		G.erase(o);
+		G[o].clear();
 	}
 
-	// 迁移入边到行星终点容器
-	if (node_in_list.count(o)) {
-		for (int i : node_in_list[o]) {
-			if (G[i].count(o)) {
-				m_centroid_end_map[o][i] = std::move(G[i][o]);
-				G[i].erase(o);
-			}
-		}
+	// 迁移入边到行星终点容器（按反向索引遍历）
+	for (int e : in_edges[o]) {
+		int i = edge_from[e];
+		auto it = G[i].find(o);
+		if (it != G[i].end()) G[i].erase(it);
+		m_centroid_end_map[o][i] = e;
 	}
 }
 
@@ -172,9 +520,89 @@ void CGraph::basic_set_centroid(
 py::dict CGraph::get_graph_info() {
 	py::dict result;
 
-	result["number_of_node"] = m_node_map.size();
+	result["number_of_node"] = node_ids.size();
 	result["number_of_link"] = number_link;
+	result["memory_usage"] = get_memory_usage();
+
+	return result;
+}
+
+
+// 统计各结构的内存用量
+void CGraph::collect_memory_usage(
+	MemoryUsage& usage) const
+{
+	// 1.节点表
+	usage.add("node_ids", vector_bytes(node_ids));
+	usage.add("node_index", hash_table_bytes(node_index));
+
+	size_t node_map = vector_bytes(m_node_map);
+	for (const auto& attrs : m_node_map) {
+		node_map += hash_table_bytes(attrs);
+		for (const auto& item : attrs) node_map += string_bytes(item.first);
+	}
+	usage.add("m_node_map", node_map);
+
+	// 2.邻接结构
+	size_t g = vector_bytes(G);
+	for (const auto& row : G) g += hash_table_bytes(row);
+	usage.add("G", g);
+
+	size_t g_temp = hash_table_bytes(G_temp);
+	for (const auto& row : G_temp) g_temp += vector_bytes(row.second);
+	usage.add("G_temp", g_temp);
 
+	auto centroid_bytes = [](const CentroidGraph& graph) {
+		size_t bytes = hash_table_bytes(graph);
+		for (const auto& row : graph) bytes += hash_table_bytes(row.second);
+		return bytes;
+	};
+	usage.add("m_centroid_start_map", centroid_bytes(m_centroid_start_map));
+	usage.add("m_centroid_end_map", centroid_bytes(m_centroid_end_map));
+
+	size_t in_index = vector_bytes(in_edges);
+	for (const auto& row : in_edges) in_index += vector_bytes(row);
+	usage.add("in_edges", in_index);
+
+	// 3.边表与属性列
+	usage.add("edge_table", vector_bytes(edge_from) + vector_bytes(edge_to) + vector_bytes(free_edges));
+
+	size_t attr = hash_table_bytes(edge_attr.field_index) + vector_bytes(edge_attr.field_names) +
+		vector_bytes(edge_attr.values) + vector_bytes(edge_attr.present) + vector_bytes(edge_attr.count);
+	for (const auto& item : edge_attr.field_index) attr += string_bytes(item.first);
+	for (const auto& name : edge_attr.field_names) attr += string_bytes(name);
+	for (const auto& column : edge_attr.values) attr += vector_bytes(column);
+	for (const auto& bits : edge_attr.present) attr += vector_bytes(bits);
+	usage.add("edge_attr", attr);
+
+	usage.add("edge_log", vector_bytes(edge_log));
+	usage.add("node_coords", vector_bytes(node_x) + vector_bytes(node_y));
+
+	// 4.映射图像的查找表与列（映射部分计入 mapped）
+	size_t img = usage.array_bytes(image.sorted_ids) + usage.array_bytes(image.sorted_index) +
+		usage.array_bytes(image.centroid_flag) + usage.array_bytes(image.out_offset) + usage.array_bytes(image.out_target) +
+		vector_bytes(image.out_weight) + vector_bytes(image.in_weight) + vector_bytes(image.out_present);
+	for (size_t f = 0; f < image.out_weight.size(); ++f) {
+		img += usage.array_bytes(image.out_weight[f]) + usage.array_bytes(image.in_weight[f]) + usage.array_bytes(image.out_present[f]);
+	}
+	usage.add("image", img);
+}
+
+
+// 获取内存用量
+py::dict CGraph::get_memory_usage() const
+{
+	MemoryUsage usage;
+	collect_memory_usage(usage);
+
+	py::dict result;
+	size_t total = 0;
+	for (const auto& item : usage.items) {
+		result[py::str(item.first)] = item.second;
+		total += item.second;
+	}
+	result["mapped"] = usage.mapped;
+	result["total"] = total;
 	return result;
 }
 
@@ -182,19 +610,22 @@ py::dict CGraph::get_graph_info() {
 // 获取点的基本信息 待修改
 py::dict CGraph::get_node_info(const py::object& id)
 {
+	thaw();
+
 	py::dict result;
 
 	try {
 		int node_id = id.cast<int>();  // 可能抛出 py::cast_error
 
 		// 检查节点是否存在
-		if (m_node_map.find(node_id) == m_node_map.end()) {
+		int u = find_node(node_id);
+		if (u == -1) {
 			result["error"] = py::str("Node " + std::to_string(node_id) + " does not exist");
 			return result;
 		}
 
-		// 计算出度（假设G是邻接表：map<int, map<int, Edge>>）
-		result["out_degree"] = G[node_id].size();
+		// 计算出度（非形心边）
+		result["out_degree"] = G[u].size();
 
 	}
 	catch (const py::cast_error& e) {
@@ -209,6 +640,8 @@ py::dict CGraph::get_node_info(const py::object& id)
 py::dict CGraph::get_link_info(
 	const py::object& start_,
 	const py::object& end_) {
+	thaw();
+
 	py::dict result;
 
 	try {
@@ -217,7 +650,7 @@ py::dict CGraph::get_link_info(
 
 		// 检查节点是否存在
 		auto check_node = [&](int node) {
-			if (m_node_map.find(node) == m_node_map.end()) {
+			if (find_node(node) == -1) {
 				result["error"] = py::str("Node " + std::to_string(node) + " does not exist");
 				return false;
 			}
@@ -228,13 +661,16 @@ py::dict CGraph::get_link_info(
 		if (!check_node(end)) return result;
 
 		// 检查边是否存在
-		if (G.find(start) == G.end() || G[start].find(end) == G[start].end()) {
+		int u = find_node(start);
+		int v = find_node(end);
+		int e = find_edge(u, v);
+		if (e == -1) {
 			result["error"] = py::str("No edge between " + std::to_string(start) + " and " + std::to_string(end));
 			return result;
 		}
 
 		// 构建属性字典
-		for (auto& pair : G[start][end]) {
+		for (auto& pair : get_edge_attrs(e)) {
 			result[pair.first.c_str()] = pair.second;
 		}
 
@@ -289,6 +725,94 @@ void CGraph::add_edges(const py::list& edges_) {
 }
 
 
+// 从 numpy 数组批量添加边
+void CGraph::add_edges_from_arrays(
+	const py::array& u_,
+	const py::array& v_,
+	const py::kwargs& fields_)
+{
+	// 1.一次性校验 dtype 与长度
+	ArrayView u(u_, "u", false);
+	ArrayView v(v_, "v", false);
+	py::ssize_t n = u_.size();
+	if (v_.size() != n) {
+		throw runtime_error("'u' and 'v' must have the same length");
+	}
+
+	vector<ArrayView> columns;
+	vector<int> column_field;
+	vector<py::array> holders; // 保持数组引用，释放 GIL 期间不被回收
+	for (const auto& item : fields_) {
+		string name = item.first.cast<string>();
+		py::array arr = py::array::ensure(item.second);
+		if (!arr) {
+			throw runtime_error("field '" + name + "' must be a numpy array");
+		}
+		if (arr.size() != n) {
+			throw runtime_error("field '" + name + "' must have the same length as 'u'");
+		}
+		columns.emplace_back(arr, name, true);
+		column_field.push_back(intern_field(name));
+		holders.push_back(arr);
+	}
+
+	// 2.释放 GIL，一次遍历建图；字段值为 NaN 视为缺失
+	py::gil_scoped_release release;
+
+	node_index.reserve(node_index.size() + static_cast<size_t>(n));
+	edge_from.reserve(edge_from.size() + static_cast<size_t>(n));
+	edge_to.reserve(edge_to.size() + static_cast<size_t>(n));
+
+	for (py::ssize_t i = 0; i < n; ++i) {
+		int o = intern_node(static_cast<int>(u.get_int(i)));
+		int d = intern_node(static_cast<int>(v.get_int(i)));
+
+		int e = basic_link_edge(o, d);
+		if (e == -1) continue;
+
+		for (size_t k = 0; k < columns.size(); ++k) {
+			double value = columns[k].get_double(i);
+			if (!std::isnan(value)) set_edge_attr(e, column_field[k], value);
+		}
+	}
+}
+
+
+// 从 numpy 数组批量设置节点坐标
+int CGraph::set_node_coords(
+	const py::array& nodes_,
+	const py::array& x_,
+	const py::array& y_)
+{
+	// 1.一次性校验 dtype 与长度
+	ArrayView nodes(nodes_, "nodes", false);
+	ArrayView x(x_, "x", true);
+	ArrayView y(y_, "y", true);
+	py::ssize_t n = nodes_.size();
+	if (x_.size() != n || y_.size() != n) {
+		throw runtime_error("'nodes', 'x' and 'y' must have the same length");
+	}
+
+	// 2.首次设置时按节点数分配坐标列，不存在的节点跳过
+	thaw();
+	if (node_x.empty()) {
+		node_x.assign(node_ids.size(), numeric_limits<double>::quiet_NaN());
+		node_y.assign(node_ids.size(), numeric_limits<double>::quiet_NaN());
+	}
+
+	int updated = 0;
+	for (py::ssize_t i = 0; i < n; ++i) {
+		int u = find_node(static_cast<int>(nodes.get_int(i)));
+		if (u == -1) continue;
+		node_x[u] = x.get_double(i);
+		node_y[u] = y.get_double(i);
+		updated++;
+	}
+	coord_version++;
+	return updated;
+}
+
+
 // 删除一条边
 void CGraph::remove_edge(
 	const py::object& start_,
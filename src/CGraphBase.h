@@ -4,6 +4,7 @@
 #include <cmath>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <future>
 #include <limits>
 #include <mutex>
@@ -11,8 +12,11 @@
 #include <string>
 #include <unordered_map>
 #include <queue>
+#include <random>
 #include <thread>
+#include <tuple>
 #include <map>
+#include <set>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
@@ -20,6 +24,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
 #include <pybind11/stl_bind.h>
+#include "GraphImage.h"
 
 #pragma once
 
@@ -27,8 +32,10 @@ using namespace std;
 using namespace chrono;
 namespace py = pybind11;
 
-using Graph = unordered_map<int, unordered_map<int, unordered_map<string, double>>>;
-using NodeMap = unordered_map<int, unordered_map<string, double>>;
+using EdgeAttr = unordered_map<string, double>;
+using Graph = vector<unordered_map<int, int>>; // 内部索引邻接：起点 -> {终点：边号}
+using CentroidGraph = unordered_map<int, unordered_map<int, int>>; // 形心点稀疏邻接（内部索引 -> 边号）
+using NodeMap = vector<EdgeAttr>; // 内部索引 -> 节点属性
 
 struct RowData {
 	int seq;
@@ -45,6 +52,363 @@ struct dis_and_path {
 	unordered_map<int, vector<int>> paths;
 };
 
+// 紧凑模式（编译时定义 GRAPHWORK_COMPACT）：CSR 权重列与搜索距离使用 32 位浮点，节省内存带宽
+// 边属性表与图像文件始终为 double
+#ifdef GRAPHWORK_COMPACT
+using weight_t = float; // CSR 权重列元素类型
+using cost_t = float; // 搜索距离类型
+#else
+using weight_t = double;
+using cost_t = double;
+#endif
+
+// 搜索工作区：按节点数分配的平铺数组，每个线程各一份、跨查询复用
+// 按代号惰性重置：stamp 不等于当前代号的节点视为未到达，开始新搜索为 O(1)
+struct SearchWorkspace {
+	vector<cost_t> dist; // 节点 -> 花费（仅已到达时有效）
+	vector<int> pred; // 节点 -> 前驱（仅已到达时有效，起点为 -1）
+	vector<unsigned> stamp; // 节点 -> 最近一次到达时的代号，0 表示从未到达
+	vector<unsigned> target_stamp; // 节点 -> 被标记为目标时的代号
+	unsigned generation = 0; // 当前代号
+	vector<pair<cost_t, int>> heap; // 二叉堆存储
+	vector<pair<cost_t, int>> quad_heap; // 索引 4 叉堆存储
+	vector<int> quad_pos; // 节点 -> 在索引 4 叉堆中的位置，-1 表示不在堆中
+	vector<vector<pair<cost_t, int>>> radix_buckets; // 基数堆各桶
+	vector<vector<pair<cost_t, int>>> dial_buckets; // 桶队列各桶（循环使用）
+
+	// 开始新的搜索
+	void reset(int num_nodes) {
+		if (static_cast<int>(stamp.size()) < num_nodes) {
+			dist.resize(num_nodes);
+			pred.resize(num_nodes);
+			stamp.resize(num_nodes, 0);
+			target_stamp.resize(num_nodes, 0);
+		}
+		if (++generation == 0) {
+			// 代号回绕：整体清零一次
+			fill(stamp.begin(), stamp.end(), 0);
+			fill(target_stamp.begin(), target_stamp.end(), 0);
+			generation = 1;
+		}
+	}
+
+	// 标记本次搜索的目标集（忽略 -1 与重复项），返回目标数
+	int mark_targets(const vector<int>& targets) {
+		int count = 0;
+		for (int t : targets) {
+			if (t == -1 || target_stamp[t] == generation) continue;
+			target_stamp[t] = generation;
+			++count;
+		}
+		return count;
+	}
+
+	// 节点确定时调用：是否为尚未确定的目标（命中后取消标记）
+	bool settle_target(int v) {
+		if (target_stamp[v] != generation) return false;
+		target_stamp[v] = 0;
+		return true;
+	}
+
+	bool reached(int v) const { return stamp[v] == generation; }
+
+	// 节点花费，未到达为 inf
+	cost_t get(int v) const {
+		return reached(v) ? dist[v] : numeric_limits<cost_t>::infinity();
+	}
+
+	void set(int v, cost_t d, int p) {
+		stamp[v] = generation;
+		dist[v] = d;
+		pred[v] = p;
+	}
+
+	// 撤销节点的到达状态
+	void clear(int v) {
+		stamp[v] = 0;
+	}
+
+	// 当前线程的工作区（slot 区分同时使用的多个工作区，如双向搜索的正反两侧）
+	static SearchWorkspace& local(int slot);
+};
+
+// 优先队列 ---------------------------------------------------------------------------------------
+// 各队列接口一致（emplace / top / pop / empty），存储取自工作区、构造时清空，作为 Dijkstra 内核的模板参数
+// 除索引 4 叉堆外均为惰性删除：同一节点可有多个条目，弹出后由内核按花费剔除过时条目
+
+// 队列类型（由 method 后缀选择）
+enum class QueueKind {
+	None, // 非 Dijkstra 方法
+	Binary, // "Dijkstra"：二叉堆
+	QuadHeap, // "Dijkstra-4ary"：索引 4 叉堆
+	Radix, // "Dijkstra-radix"：基数堆
+	Dial // "Dijkstra-dial"：桶队列
+};
+
+// 二叉堆：按 (花费, 节点) 升序弹出
+struct MinHeap {
+	vector<pair<cost_t, int>>& items;
+
+	explicit MinHeap(SearchWorkspace& ws) : items(ws.heap) {
+		items.clear();
+	}
+	bool empty() const { return items.empty(); }
+	const pair<cost_t, int>& top() const { return items.front(); }
+	void emplace(cost_t d, int v) {
+		items.emplace_back(d, v);
+		push_heap(items.begin(), items.end(), greater<>());
+	}
+	void pop() {
+		pop_heap(items.begin(), items.end(), greater<>());
+		items.pop_back();
+	}
+};
+
+// 索引 4 叉堆：每个节点至多一个条目，再次入队即降低其花费（decrease-key），不产生过时条目
+struct QuadHeap {
+	vector<pair<cost_t, int>>& items;
+	vector<int>& pos;
+
+	QuadHeap(SearchWorkspace& ws) : items(ws.quad_heap), pos(ws.quad_pos) {
+		// 上次搜索提前结束时遗留的条目
+		for (const auto& item : items) {
+			pos[item.second] = -1;
+		}
+		items.clear();
+		if (pos.size() < ws.stamp.size()) pos.resize(ws.stamp.size(), -1);
+	}
+	bool empty() const { return items.empty(); }
+	const pair<cost_t, int>& top() const { return items.front(); }
+	void emplace(cost_t d, int v) {
+		int i = pos[v];
+		if (i == -1) {
+			i = static_cast<int>(items.size());
+			items.emplace_back(d, v);
+		}
+		else if (d < items[i].first) {
+			items[i].first = d;
+		}
+		else {
+			return;
+		}
+		sift_up(i);
+	}
+	void pop() {
+		pos[items.front().second] = -1;
+		items.front() = items.back();
+		items.pop_back();
+		if (!items.empty()) sift_down(0);
+	}
+
+private:
+	void place(int i, const pair<cost_t, int>& item) {
+		items[i] = item;
+		pos[item.second] = i;
+	}
+	void sift_up(int i) {
+		pair<cost_t, int> item = items[i];
+		while (i > 0) {
+			int parent = (i - 1) >> 2;
+			if (!(item < items[parent])) break;
+			place(i, items[parent]);
+			i = parent;
+		}
+		place(i, item);
+	}
+	void sift_down(int i) {
+		pair<cost_t, int> item = items[i];
+		int n = static_cast<int>(items.size());
+		while (true) {
+			int first = 4 * i + 1;
+			if (first >= n) break;
+			int best = first;
+			for (int c = first + 1; c < min(first + 4, n); ++c) {
+				if (items[c] < items[best]) best = c;
+			}
+			if (!(items[best] < item)) break;
+			place(i, items[best]);
+			i = best;
+		}
+		place(i, item);
+	}
+};
+
+// 基数堆：要求弹出的花费单调不减（非负权重的 Dijkstra 满足）
+// 非负浮点数的位模式与数值同序，按与上次弹出值最高不同位分桶，每个条目至多下移 64 次
+struct RadixHeap {
+#ifdef GRAPHWORK_COMPACT
+	using bits_t = uint32_t;
+#else
+	using bits_t = uint64_t;
+#endif
+	static const int num_buckets = sizeof(bits_t) * 8 + 1;
+
+	vector<vector<pair<cost_t, int>>>& buckets;
+	bits_t last = 0; // 最近一次弹出的键
+	size_t count = 0;
+
+	explicit RadixHeap(SearchWorkspace& ws) : buckets(ws.radix_buckets) {
+		buckets.resize(num_buckets);
+		for (auto& b : buckets) b.clear();
+	}
+	bool empty() const { return count == 0; }
+	void emplace(cost_t d, int v) {
+		buckets[bucket_of(key_of(d))].emplace_back(d, v);
+		++count;
+	}
+	const pair<cost_t, int>& top() {
+		if (buckets[0].empty()) refill();
+		return buckets[0].back();
+	}
+	void pop() {
+		top();
+		buckets[0].pop_back();
+		--count;
+	}
+
+private:
+	static bits_t key_of(cost_t d) {
+		bits_t key;
+		memcpy(&key, &d, sizeof(key));
+		return key;
+	}
+	int bucket_of(bits_t key) const {
+		bits_t diff = key ^ last;
+		if (diff == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<int>(sizeof(unsigned long long) * 8) - __builtin_clzll(diff);
+#else
+		int b = 0;
+		for (; diff != 0; diff >>= 1) ++b;
+		return b;
+#endif
+	}
+	// 取最低的非空桶，以其中最小键为新的 last 并将该桶条目重新分桶（均落入更低的桶）
+	void refill() {
+		int i = 1;
+		while (buckets[i].empty()) ++i;
+		auto& src = buckets[i];
+		bits_t min_key = key_of(src[0].first);
+		for (const auto& item : src) min_key = min(min_key, key_of(item.first));
+		last = min_key;
+		for (const auto& item : src) {
+			buckets[bucket_of(key_of(item.first))].push_back(item);
+		}
+		src.clear();
+	}
+};
+
+// 桶队列（Dial）：花费按桶宽取整后落入循环桶，自最小桶号顺序弹出；桶内按花费组成小顶堆
+// 整数权重时每个桶只含同一花费，即经典 Dial 算法；要求弹出的花费单调不减
+// 待弹出的花费跨度超过桶数时桶数加倍，桶数达到上限后改为桶宽加倍
+struct BucketQueue {
+	static const size_t max_buckets = size_t(1) << 20;
+
+	vector<vector<pair<cost_t, int>>>& buckets;
+	vector<pair<cost_t, int>> unbounded; // 花费为 inf 的条目，最后弹出
+	double width = 1.0; // 桶宽
+	long long cursor = 0; // 当前最小桶号
+	long long high = 0; // 已入队的最大桶号
+	size_t count = 0; // 桶内条目数
+
+	explicit BucketQueue(SearchWorkspace& ws) : buckets(ws.dial_buckets) {
+		if (buckets.empty()) buckets.resize(64);
+		for (auto& b : buckets) b.clear();
+	}
+	bool empty() const { return count == 0 && unbounded.empty(); }
+	void emplace(cost_t d, int v) {
+		if (!(d < numeric_limits<cost_t>::infinity())) {
+			unbounded.emplace_back(d, v);
+			return;
+		}
+		long long k = key_of(d);
+		if (count == 0) {
+			cursor = high = k;
+		}
+		else {
+			// 首次弹出前的入队（如形心点的各条出边）可低于 cursor
+			cursor = min(cursor, k);
+			high = max(high, k);
+		}
+		if (high - cursor >= static_cast<long long>(buckets.size())) {
+			grow();
+			k = key_of(d);
+		}
+		push(buckets[k & (buckets.size() - 1)], d, v);
+		++count;
+	}
+	const pair<cost_t, int>& top() {
+		if (count == 0) return unbounded.back();
+		while (buckets[cursor & (buckets.size() - 1)].empty()) ++cursor;
+		return buckets[cursor & (buckets.size() - 1)].front();
+	}
+	void pop() {
+		if (count == 0) {
+			unbounded.pop_back();
+			return;
+		}
+		top();
+		auto& b = buckets[cursor & (buckets.size() - 1)];
+		pop_heap(b.begin(), b.end(), greater<>());
+		b.pop_back();
+		--count;
+	}
+
+private:
+	long long key_of(cost_t d) const {
+		return static_cast<long long>(d / width);
+	}
+	static void push(vector<pair<cost_t, int>>& b, cost_t d, int v) {
+		b.emplace_back(d, v);
+		push_heap(b.begin(), b.end(), greater<>());
+	}
+	// 扩大桶数或桶宽，直至 [cursor, high] 落入同一轮循环，再将现有条目重新分桶
+	void grow() {
+		vector<pair<cost_t, int>> items;
+		items.reserve(count);
+		for (auto& b : buckets) {
+			items.insert(items.end(), b.begin(), b.end());
+			b.clear();
+		}
+		size_t size = buckets.size();
+		while (high - cursor >= static_cast<long long>(size)) {
+			if (size < max_buckets) {
+				size *= 2;
+			}
+			else {
+				width *= 2;
+				cursor >>= 1;
+				high >>= 1;
+			}
+		}
+		buckets.resize(size);
+		for (const auto& item : items) {
+			push(buckets[key_of(item.first) & (size - 1)], item.first, item.second);
+		}
+	}
+};
+
+// 最短路搜索结果（内部索引）：花费与前驱保存在当前线程的工作区中，在同一线程开始下一次搜索前有效
+struct SearchResult {
+	SearchWorkspace* workspace = nullptr; // 花费与前驱所在的工作区
+	vector<int> touched; // 到达的节点（内部索引），仅含 cut_off 以内
+
+	// 节点花费，未到达为 inf
+	cost_t dist(int v) const {
+		return workspace->get(v);
+	}
+
+	// 沿前驱回溯起点到 v 的路径（v 须已到达）
+	vector<int> path(int v) const {
+		vector<int> nodes;
+		for (; v != -1; v = workspace->pred[v]) {
+			nodes.push_back(v);
+		}
+		reverse(nodes.begin(), nodes.end());
+		return nodes;
+	}
+};
+
 struct shortest_Path {
 	double length;
 	vector<int> nodes;
@@ -87,33 +451,560 @@ private:
 	std::set<std::vector<int>> seenPaths;  // 用于存储已经插入的路径
 };
 
+// 边增删记录（仅非形心边），供快照增量层回放
+struct EdgeEdit {
+	int from; // 起点（内部索引）
+	int to; // 终点（内部索引）
+	int edge; // 边号
+	bool removed; // true 删边，false 加边
+};
+
+// 压缩稀疏行(CSR)只读图快照：与 CGraph 共用内部索引，正反向拓扑 + 按字段的权重列
+// 快照之后的少量加边进入仅追加的增量层，删边在基础 CSR 上打墓碑，查询时合并遍历
+struct CSRGraph {
+	int num_nodes = 0; // 节点数（含快照之后新增的节点）
+	int num_base_nodes = 0; // 基础 CSR 覆盖的节点数
+	int num_edges = 0; // 基础 CSR 边数
+	long long version = -1; // 快照对应的图版本
+	long long layout_version = -1; // 快照对应的布局版本
+	long long generation = 0; // 基础 CSR 代号，每次重建递增
+
+	// 各数组自身持有数据（freeze 构建），或直接指向映射的图像文件（load）
+	ArrayRef<int> out_offset; // 正向邻接偏移，长度 num_nodes + 1
+	ArrayRef<int> out_target; // 正向邻接终点
+	ArrayRef<int> in_offset; // 反向邻接偏移，长度 num_nodes + 1
+	ArrayRef<int> in_source; // 反向邻接起点
+
+	ArrayRef<int> edge_id; // 正向位置 -> 边号（映射加载的快照为空）
+	ArrayRef<int> in_edge; // 反向位置 -> 正向位置（映射加载的快照为空）
+
+	// 权重列按字段惰性构建，快照重建时整体失效
+	unordered_map<string, int> field_index; // 字段名 -> 权重列序号
+	vector<ArrayRef<weight_t>> out_weight; // 正向权重列（与 out_target 对齐）
+	vector<ArrayRef<weight_t>> in_weight; // 反向权重列（与 in_source 对齐）
+	vector<int> free_columns; // 已释放、可复用的权重列序号
+
+	// 增量层
+	vector<EdgeEdit> delta_log; // 基础 CSR 之后已回放的增删记录
+	vector<int> delta_from; // 增量边起点
+	vector<int> delta_to; // 增量边终点
+	vector<int> delta_edge; // 增量边边号，已删除为 -1
+	vector<int> delta_out_head; // 节点 -> 首条增量出边，-1 表示无
+	vector<int> delta_out_next; // 增量边 -> 同起点的下一条
+	vector<int> delta_in_head; // 节点 -> 首条增量入边
+	vector<int> delta_in_next; // 增量边 -> 同终点的下一条
+	vector<vector<weight_t>> delta_weight; // 权重列序号 -> 增量边权重
+	vector<uint64_t> out_dead; // 基础边墓碑位（按正向位置）
+	vector<uint64_t> in_dead; // 基础边墓碑位（按反向位置）
+	int num_dead = 0; // 墓碑数
+
+	// 是否有增量
+	bool has_delta() const {
+		return !delta_log.empty();
+	}
+
+	// 遍历 u 的出边（基础 + 增量，跳过墓碑），visit(终点, 权重)
+	template <typename Visit>
+	void for_each_out(int u, int weight_index, Visit&& visit) const {
+		const auto& weight = out_weight[weight_index];
+		if (u < num_base_nodes) {
+			for (int e = out_offset[u]; e < out_offset[u + 1]; ++e) {
+				if (num_dead != 0 && ((out_dead[e >> 6] >> (e & 63)) & 1)) continue;
+				visit(out_target[e], weight[e]);
+			}
+		}
+		if (u < static_cast<int>(delta_out_head.size())) {
+			for (int i = delta_out_head[u]; i != -1; i = delta_out_next[i]) {
+				if (delta_edge[i] != -1) visit(delta_to[i], delta_weight[weight_index][i]);
+			}
+		}
+	}
+
+	// 遍历 u 的入边（基础 + 增量，跳过墓碑），visit(起点, 权重)
+	template <typename Visit>
+	void for_each_in(int u, int weight_index, Visit&& visit) const {
+		const auto& weight = in_weight[weight_index];
+		if (u < num_base_nodes) {
+			for (int e = in_offset[u]; e < in_offset[u + 1]; ++e) {
+				if (num_dead != 0 && ((in_dead[e >> 6] >> (e & 63)) & 1)) continue;
+				visit(in_source[e], weight[e]);
+			}
+		}
+		if (u < static_cast<int>(delta_in_head.size())) {
+			for (int i = delta_in_head[u]; i != -1; i = delta_in_next[i]) {
+				if (delta_edge[i] != -1) visit(delta_from[i], delta_weight[weight_index][i]);
+			}
+		}
+	}
+
+	// 遍历 u 的出边终点（只用拓扑，不取权重列）
+	template <typename Visit>
+	void for_each_out_node(int u, Visit&& visit) const {
+		if (u < num_base_nodes) {
+			for (int e = out_offset[u]; e < out_offset[u + 1]; ++e) {
+				if (num_dead != 0 && ((out_dead[e >> 6] >> (e & 63)) & 1)) continue;
+				visit(out_target[e]);
+			}
+		}
+		if (u < static_cast<int>(delta_out_head.size())) {
+			for (int i = delta_out_head[u]; i != -1; i = delta_out_next[i]) {
+				if (delta_edge[i] != -1) visit(delta_to[i]);
+			}
+		}
+	}
+
+	// 基础边 u->v 的正向位置，不存在或已删除返回 -1
+	int find_base_edge(int u, int v) const {
+		if (u >= num_base_nodes) return -1;
+		const int* first = out_target.begin() + out_offset[u];
+		const int* last = out_target.begin() + out_offset[u + 1];
+		const int* it = lower_bound(first, last, v);
+		if (it == last || *it != v) return -1;
+		int e = static_cast<int>(it - out_target.begin());
+		if (num_dead != 0 && ((out_dead[e >> 6] >> (e & 63)) & 1)) return -1;
+		return e;
+	}
+
+	// 基础边 u->v 的反向位置（u->v 须存在）
+	int find_base_in_edge(int u, int v) const {
+		const int* first = in_source.begin() + in_offset[v];
+		const int* last = in_source.begin() + in_offset[v + 1];
+		return static_cast<int>(lower_bound(first, last, u) - in_source.begin());
+	}
+
+	// 存活的增量边 u->v 的序号，不存在返回 -1
+	int find_delta_edge(int u, int v) const {
+		if (u >= static_cast<int>(delta_out_head.size())) return -1;
+		for (int i = delta_out_head[u]; i != -1; i = delta_out_next[i]) {
+			if (delta_to[i] == v && delta_edge[i] != -1) return i;
+		}
+		return -1;
+	}
+};
+
+// 度为 2 的链收缩：链内部节点在收缩图中没有边，链两端以捷径边相连，捷径权重为链上各边权重之和
+struct ChainIndex {
+	bool enabled = false; // 是否启用收缩
+	long long version = -1; // 对应快照的图版本
+	long long generation = -1; // 对应快照代号
+	long long weight_version = -1; // 收缩图权重列对应的权重版本
+	CSRGraph graph; // 收缩图（与快照共用内部索引，权重列序号与快照一致）
+	vector<char> interior; // 节点 -> 是否为链内部节点
+	vector<int> base_pos; // 收缩图正向位置 -> 快照正向位置，捷径为 -1
+	vector<int> shortcut; // 收缩图正向位置 -> 捷径序号，原始边为 -1
+	vector<int> chain_from; // 捷径序号 -> 起点
+	vector<int> from_offset; // 节点 -> 以其为起点的捷径序号区间（捷径按起点升序），长度 num_nodes + 1
+	vector<int> chain_offset; // 捷径序号 -> chain_nodes 区间，第 s 条捷径的 chain_pos 区间起点为 chain_offset[s] + s
+	vector<int> chain_nodes; // 各捷径依次经过的内部节点
+	vector<int> chain_pos; // 各捷径依次经过的快照正向位置（比内部节点多一项）
+
+	// 捷径数
+	int num_chains() const {
+		return static_cast<int>(chain_from.size());
+	}
+};
+
+// 均匀网格空间索引：节点按坐标落入网格单元，边（两端坐标间的线段）登记到其包围盒覆盖的各单元
+struct SpatialGrid {
+	long long graph_version = -1; // 对应的图版本
+	long long coord_version = -1; // 对应的坐标版本
+	double min_x = 0.0; // 网格原点
+	double min_y = 0.0;
+	double cell = 1.0; // 单元边长
+	int cols = 0; // 列数
+	int rows = 0; // 行数
+	vector<int> node_offset; // 单元 -> node_items 区间，长度 cols * rows + 1
+	vector<int> node_items; // 各单元内的节点（内部索引）
+	vector<int> edge_offset; // 单元 -> edge_items 区间
+	vector<int> edge_items; // 各单元登记的边号
+
+	// 坐标所在单元的列、行（网格外的坐标取最近的单元，先在 double 上截断再转换，避免溢出 int）
+	int col_of(double x) const {
+		return static_cast<int>(min(double(cols - 1), max(0.0, floor((x - min_x) / cell))));
+	}
+	int row_of(double y) const {
+		return static_cast<int>(min(double(rows - 1), max(0.0, floor((y - min_y) / cell))));
+	}
+};
+
+// ALT 路标索引（单个权重字段）：各路标与全部节点间的正反向最短花费，按节点连续存放（节点 v 的第 i 个路标位于 v * 路标数 + i）
+struct LandmarkIndex {
+	long long graph_version = -1; // 对应的图版本
+	long long weight_version = -1; // 对应的权重版本
+	int num_landmarks = 0; // 请求的路标数
+	string selection; // 路标选择方法（"farthest" 或 "avoid"）
+	int num_thread = 1; // 构建线程数（图或权重修改后按原参数重建）
+	vector<int> landmarks; // 路标（内部索引）
+	vector<cost_t> from; // 路标 -> 节点的花费，不可达为 inf
+	vector<cost_t> to; // 节点 -> 路标的花费，不可达为 inf
+
+	// 由三角不等式得到的 u -> v 花费下界（不可达的路标不参与）
+	double lower_bound(int u, int v) const {
+		const int k = static_cast<int>(landmarks.size());
+		const cost_t* to_u = to.data() + static_cast<size_t>(u) * k;
+		const cost_t* to_v = to.data() + static_cast<size_t>(v) * k;
+		const cost_t* from_u = from.data() + static_cast<size_t>(u) * k;
+		const cost_t* from_v = from.data() + static_cast<size_t>(v) * k;
+		const cost_t inf = numeric_limits<cost_t>::infinity();
+		double bound = 0.0;
+		for (int i = 0; i < k; ++i) {
+			// d(u, L) <= d(u, v) + d(v, L)
+			if (to_u[i] < inf && to_v[i] < inf) bound = max(bound, static_cast<double>(to_u[i]) - to_v[i]);
+			// d(L, v) <= d(L, u) + d(u, v)
+			if (from_u[i] < inf && from_v[i] < inf) bound = max(bound, static_cast<double>(from_v[i]) - from_u[i]);
+		}
+		return bound;
+	}
+};
+
+// 收缩层次（单个权重字段）：按 rank 由低到高收缩节点，收缩时为其邻点之间补充捷径
+// 向上弧 u->v（rank[v] > rank[u]）存于 u，供正向搜索；向下弧 u->v（rank[u] > rank[v]）存于 v，供反向搜索与自上而下扫描
+// 各节点的弧按另一端升序排列，同一对节点至多一条；捷径记录被收缩的中间节点，原始边为 -1
+struct ContractionHierarchy {
+	long long graph_version = -1; // 对应的图版本
+	long long weight_version = -1; // 对应的权重版本
+	vector<int> rank; // 节点 -> 收缩次序
+	vector<int> order; // 收缩次序 -> 节点
+	vector<int> up_offset; // 节点 -> 向上弧区间
+	vector<int> up_target;
+	vector<cost_t> up_weight;
+	vector<int> up_middle;
+	vector<int> down_offset; // 节点 -> 指向该节点的向下弧区间
+	vector<int> down_source;
+	vector<cost_t> down_weight;
+	vector<int> down_middle;
+	vector<int> sweep_offset; // 收缩次序 -> 向下弧区间（PHAST 线性扫描用，两端均为收缩次序）
+	vector<int> sweep_source;
+	vector<cost_t> sweep_weight;
+	int num_shortcuts = 0; // 捷径数
+
+	// 弧 u->v 的中间节点（弧须存在）
+	int middle(int u, int v) const {
+		if (rank[u] < rank[v]) {
+			const int* first = up_target.data() + up_offset[u];
+			const int* last = up_target.data() + up_offset[u + 1];
+			return up_middle[lower_bound(first, last, v) - up_target.data()];
+		}
+		const int* first = down_source.data() + down_offset[v];
+		const int* last = down_source.data() + down_offset[v + 1];
+		return down_middle[lower_bound(first, last, u) - down_source.data()];
+	}
+
+	// 将弧 u->v 展开为原图路径，依次追加 u 之后的各节点（不含 u）
+	void unpack(int u, int v, vector<int>& path) const {
+		vector<pair<int, int>> stack{ { u, v } };
+		while (!stack.empty()) {
+			auto arc = stack.back();
+			stack.pop_back();
+			int m = middle(arc.first, arc.second);
+			if (m == -1) {
+				path.push_back(arc.second);
+				continue;
+			}
+			stack.emplace_back(m, arc.second);
+			stack.emplace_back(arc.first, m);
+		}
+	}
+};
+
+// 多层分区覆盖图（CRP）的一层：单元由下一层相邻单元合并而成（第 1 层由节点合并）
+struct OverlayLevel {
+	int num_cells = 0;
+	vector<int> cell; // 节点 -> 单元
+	vector<int> entry_offset; // 单元 -> 入口区间（有来自单元外入边的节点，按节点升序）
+	vector<int> entries;
+	vector<int> exit_offset; // 单元 -> 出口区间（有指向单元外出边的节点，按节点升序）
+	vector<int> exits;
+	vector<int> entry_pos; // 节点 -> 在所属单元入口中的序号，非入口为 -1
+	vector<int> exit_pos; // 节点 -> 在所属单元出口中的序号，非出口为 -1
+	vector<size_t> clique_offset; // 单元 -> 团花费起点（入口 × 出口，按入口行优先）
+};
+
+// 多层分区覆盖图：只依赖拓扑，权重修改后无需重建，重新定制团花费即可
+struct MultilevelOverlay {
+	long long graph_version = -1; // 对应的图版本（-1 表示未构建）
+	int cell_size = 0; // 第 1 层单元节点数上限
+	int num_levels = 0; // 请求的层数（单元无法继续合并时实际层数更少）
+	int fanout = 0; // 每升一层单元节点数上限的倍数
+	vector<OverlayLevel> levels; // levels[l - 1] 为第 l 层，第 0 层为原图
+
+	// 节点 u 在第 l 层（l >= 1）所属单元
+	int cell(int l, int u) const { return levels[l - 1].cell[u]; }
+};
+
+// 覆盖图在某权重字段下的团花费：单元内各入口到各出口只经单元内节点的最短花费
+struct OverlayMetric {
+	long long graph_version = -1; // 对应的图版本
+	long long weight_version = -1; // 对应的权重版本
+	int num_thread = 1; // 定制线程数（过期后按原参数重新定制）
+	vector<vector<cost_t>> clique; // 层 -> 各单元团花费，不可达为 inf
+};
+
+// 边属性列存储：每个字段一列连续数组（按边号索引）+ 存在位图，缺失值不占用哈希表
+struct EdgeColumns {
+	unordered_map<string, int> field_index; // 字段名 -> 列号
+	vector<string> field_names; // 列号 -> 字段名
+	vector<vector<double>> values; // 列号 -> 按边号排列的字段值
+	vector<vector<uint64_t>> present; // 列号 -> 存在位图（每位对应一条边）
+	vector<int> count; // 列号 -> 存活边中该字段出现数
+	int num_slots = 0; // 边号容量
+
+	// 字段列号，不存在返回 -1
+	int find(const string& name) const {
+		auto it = field_index.find(name);
+		return it == field_index.end() ? -1 : it->second;
+	}
+
+	// 边 e 是否有字段 f
+	bool has(int f, int e) const {
+		return (present[f][e >> 6] >> (e & 63)) & 1;
+	}
+
+	// 读取字段值，缺失返回 default_value
+	double get(int f, int e, double default_value) const {
+		return (f != -1 && has(f, e)) ? values[f][e] : default_value;
+	}
+};
+
+// numpy 一维数组只读视图：dtype 只校验一次，按步长直接读取缓冲区
+struct ArrayView {
+	const char* data = nullptr;
+	py::ssize_t stride = 0;
+	char kind = 0;
+	py::ssize_t itemsize = 0;
+
+	// 校验并绑定数组，allow_float 为 false 时只接受整数类型（节点编号），且各值须在 int32 范围内
+	ArrayView(const py::array& arr, const string& name, bool allow_float) {
+		if (arr.ndim() != 1) {
+			throw runtime_error("'" + name + "' must be a 1-D array");
+		}
+		kind = arr.dtype().kind();
+		itemsize = arr.itemsize();
+		bool is_int = (kind == 'i' || kind == 'u') && (itemsize == 4 || itemsize == 8);
+		bool is_float = kind == 'f' && (itemsize == 4 || itemsize == 8);
+		if (!is_int && !(allow_float && is_float)) {
+			throw runtime_error("'" + name + "' has unsupported dtype, expected " +
+				(allow_float ? "int32/int64/float32/float64" : "int32/int64"));
+		}
+		data = static_cast<const char*>(arr.data());
+		stride = arr.strides(0);
+
+		// 节点编号为 int，越界值截断后会与其他节点合并，逐项检查（int32 本身无需检查）
+		if (!allow_float && !(kind == 'i' && itemsize == 4)) {
+			for (py::ssize_t i = 0; i < arr.size(); ++i) {
+				const char* p = data + i * stride;
+				bool in_range = kind == 'u'
+					? (itemsize == 4 ? *reinterpret_cast<const uint32_t*>(p) : *reinterpret_cast<const uint64_t*>(p)) <= static_cast<uint64_t>(INT32_MAX)
+					: get_int(i) >= INT32_MIN && get_int(i) <= INT32_MAX;
+				if (!in_range) {
+					throw runtime_error("'" + name + "' value at index " + to_string(i) + " is out of int32 range");
+				}
+			}
+		}
+	}
+
+	long long get_int(py::ssize_t i) const {
+		const char* p = data + i * stride;
+		if (kind == 'u') return itemsize == 4 ? *reinterpret_cast<const uint32_t*>(p) : static_cast<long long>(*reinterpret_cast<const uint64_t*>(p));
+		return itemsize == 4 ? *reinterpret_cast<const int32_t*>(p) : *reinterpret_cast<const int64_t*>(p);
+	}
+
+	double get_double(py::ssize_t i) const {
+		if (kind != 'f') return static_cast<double>(get_int(i));
+		const char* p = data + i * stride;
+		return itemsize == 4 ? *reinterpret_cast<const float*>(p) : *reinterpret_cast<const double*>(p);
+	}
+};
+
+// 内存估算 ---------------------------------------------------------------------------------------
+// 堆块估算字节数：请求大小 + 分配器块头，按 16 字节对齐，最小 32 字节（glibc malloc）
+inline size_t heap_block_bytes(
+	size_t bytes)
+{
+	if (bytes == 0) return 0;
+	return max<size_t>(32, (bytes + sizeof(size_t) + 15) / 16 * 16);
+}
+
+// 字符串堆内存（短字符串内联存储时为 0）
+inline size_t string_bytes(
+	const string& str)
+{
+	return str.capacity() > 15 ? heap_block_bytes(str.capacity() + 1) : 0;
+}
+
+// 连续数组的堆内存（按容量计）
+template <typename T>
+size_t vector_bytes(
+	const vector<T>& values)
+{
+	return heap_block_bytes(values.capacity() * sizeof(T));
+}
+
+// 哈希表自身的堆内存：桶数组 + 每元素一个节点（next 指针 + 元素 + 缓存的哈希值），不含元素内部的堆内存
+template <typename Table>
+size_t hash_table_bytes(
+	const Table& table)
+{
+	size_t node = sizeof(void*) + sizeof(typename Table::value_type) + sizeof(size_t);
+	size_t buckets = table.bucket_count() > 1 ? heap_block_bytes(table.bucket_count() * sizeof(void*)) : 0; // 空表使用内置单桶
+	return buckets + table.size() * heap_block_bytes(node);
+}
+
+// 内存用量统计：按结构累计估算字节数，映射区域（文件或共享内存）按地址去重单独计数
+struct MemoryUsage {
+	vector<pair<string, size_t>> items; // 结构名 -> 堆内存字节数
+	set<const void*> mapped_arrays; // 已计数的映射数组
+	size_t mapped = 0; // 映射区域字节数
+
+	void add(const string& name, size_t bytes) {
+		items.emplace_back(name, bytes);
+	}
+
+	// 只读数组：自有数据计入堆内存，指向映射区域的计入 mapped 并返回 0
+	template <typename T>
+	size_t array_bytes(const ArrayRef<T>& values) {
+		if (values.empty()) return 0;
+		if (values.mutable_data() != nullptr) return heap_block_bytes(values.size() * sizeof(T));
+		if (mapped_arrays.insert(values.data()).second) mapped += values.size() * sizeof(T);
+		return 0;
+	}
+};
+
+
 class CGraph {
 public:
-	Graph G; // 图：起点节点：{终点节点1：属性字典1，终点节点2：属性字典2}			非形心点图
+	vector<int> node_ids; // 内部索引 -> 原始节点编号
+	unordered_map<int, int> node_index; // 原始节点编号 -> 内部索引
+
+	Graph G; // 图：起点：{终点1：属性字典1，终点2：属性字典2}（内部索引）	非形心点图
 	unordered_map<int, vector<pair<int, double>>> G_temp;
-	Graph m_centroid_start_map; // 哈希表 起点：{终点1：属性字典1，终点2：属性字典2}  形心点图
-	Graph m_centroid_end_map; // 哈希表 终点：{起点1：属性字典1，起点2：属性字典2}	形心点图
-	NodeMap m_node_map; // 节点哈希表
+	CentroidGraph m_centroid_start_map; // 哈希表 起点：{终点1：属性字典1，终点2：属性字典2}  形心点图
+	CentroidGraph m_centroid_end_map; // 哈希表 终点：{起点1：属性字典1，起点2：属性字典2}	形心点图
+	NodeMap m_node_map; // 节点属性表（内部索引）
 	int number_link = 0; // 边数
-	unordered_map<int, unordered_set<int>> node_in_list; // 节点前导点 
-	unordered_map<int, unordered_set<int>> node_out_list; // 节点邻接点
+	long long graph_version = 0; // 图版本号，每次修改递增
+	long long weight_version = 0; // 边权重版本号，原地修改权重时递增（拓扑不变）
+	long long layout_version = 0; // 布局版本号，需整体重建快照的修改（设形心点、增删记录溢出）时递增
+	vector<EdgeEdit> edge_log; // 尚未并入快照的非形心边增删记录
+	bool edge_log_enabled = false; // 已有可增量更新的快照时才记录
 
-	unordered_map<string, int> field_freq; // 字段出现数
-	vector< unordered_map<int, vector<pair<int, double>>> > full_field_map; // 全勤字段数据存储表
-	vector< string > field_vec; // 全勤字段存储序列
-	vector< unordered_map<int, vector<pair<int, double>>> > full_field_reverse_map; // 反向全勤字段数据存储表
+	// 边表：每条边只存一份，边号稳定（删除后回收复用）；G 与形心容器为其正向索引，in_edges 为反向索引
+	vector<int> edge_from; // 边号 -> 起点（内部索引）
+	vector<int> edge_to; // 边号 -> 终点（内部索引）
+	vector<vector<int>> in_edges; // 节点 -> 入边边号（含形心边）
+	vector<int> free_edges; // 已删除、可复用的边号
+	EdgeColumns edge_attr; // 边属性列存储
+	GraphImage image; // 映射加载的图像（可变结构重建前有效）
+	vector<double> node_x; // 内部索引 -> x 坐标（未设置坐标时为空，缺失为 NaN）
+	vector<double> node_y; // 内部索引 -> y 坐标
+	long long coord_version = 0; // 坐标版本号，设置坐标时递增
 
 	// 初始化
 	CGraph() {
-		Graph G;
 	}
 
+	// 节点索引 ---------------------------------------------------------------------------------------
+	// 获取或分配内部索引
+	int intern_node(
+		int node);
+
+
+	// 原始编号转内部索引，不存在返回 -1
+	int find_node(
+		int node) const;
+
+
+	// 原始编号列表转内部索引，跳过不存在的节点
+	vector<int> find_nodes(
+		const vector<int>& nodes) const;
+
+
+	// 判断是否为形心点（内部索引）
+	bool is_centroid(
+		int u) const;
+
+
+	// 由映射图像重建可变结构（哈希邻接、节点表、边表），未处于映射状态时直接返回
+	void thaw();
+
+
+	// 节点是否有坐标（内部索引）
+	bool has_coord(
+		int u) const;
+
+
+	// 按新顺序重排内部索引，order[新索引] = 旧索引；各按内部索引组织的结构同步重排，快照需整体重建
+	void permute_nodes(
+		const vector<int>& order);
+
+	// 边属性 ---------------------------------------------------------------------------------------
+	// 分配边号
+	int new_edge(
+		int o,
+		int d);
+
+
+	// 回收边号，清除其全部属性
+	void release_edge(
+		int e);
+
+
+	// 查找边 o->d 的边号（按形心属性定位所在容器），不存在返回 -1
+	int find_edge(
+		int o,
+		int d) const;
+
+
+	// 获取或新建字段列
+	int intern_field(
+		const string& name);
+
+
+	// 设置边属性
+	void set_edge_attr(
+		int e,
+		int f,
+		double value);
+
+
+	// 读取边权重（字段列号为 -1 或缺失时按 1.0 处理）
+	double get_edge_weight(
+		int e,
+		int f) const;
+
+
+	// 读取边的全部属性
+	EdgeAttr get_edge_attrs(
+		int e) const;
+
+
+	// 字段出现数（视图）
+	unordered_map<string, int> field_freq() const;
+
+
+	// 全勤字段序列（视图）：所有边均有值的字段
+	vector<string> field_vec() const;
+
 	// 基本算法 ---------------------------------------------------------------------------------------
 	// 加边
 	virtual void basic_add_edge(
 		const int o,
 		const int d,
-		const unordered_map<string, double> attribute_dict_);
+		const unordered_map<string, double>& attribute_dict_);
+
+
+	// 挂接一条新边（内部索引），返回边号；边已存在返回 -1
+	int basic_link_edge(
+		int o,
+		int d);
+
+
+	// 记录非形心边增删，记录过多时改为整体重建
+	void log_edge_edit(
+		int o,
+		int d,
+		int e,
+		bool removed);
 
 
 	// 删边
@@ -133,6 +1024,15 @@ public:
 	virtual py::dict get_graph_info();
 
 
+	// 统计各结构的内存用量
+	virtual void collect_memory_usage(
+		MemoryUsage& usage) const;
+
+
+	// 获取内存用量（字节）：各结构估算值、映射区域与堆内存合计
+	py::dict get_memory_usage() const;
+
+
 	// 获取点的基本信息
 	virtual py::dict get_node_info(
 		const py::object& id);
@@ -156,6 +1056,20 @@ public:
 		const py::list& edges_);
 
 
+	// 从 numpy 数组批量设置节点坐标，返回实际设置的节点数
+	int set_node_coords(
+		const py::array& nodes_,
+		const py::array& x_,
+		const py::array& y_);
+
+
+	// 从 numpy 数组批量添加边
+	virtual void add_edges_from_arrays(
+		const py::array& u_,
+		const py::array& v_,
+		const py::kwargs& fields_);
+
+
 	// 删除一条边
 	virtual void remove_edge(
 		const py::object& u_,
@@ -3,402 +3,3263 @@
 // 定义一个互斥锁
 mutex result_mutex;
 
-// 核心算法 ---------------------------------------------------------------------------------------
-// 多源花费
-unordered_map<int, double> GraphAlgorithms::multi_source_dijkstra_cost(
-	const unordered_map<int, vector<pair<int, double>>>& g,
+
+// 将 [0, n) 分段并行执行，规模较小时直接在当前线程执行
+static void parallel_ranges(
+	size_t n,
+	const function<void(size_t, size_t)>& body)
+{
+	const size_t min_chunk = 1 << 18;
+	size_t num_thread = min<size_t>(max(1u, thread::hardware_concurrency()), (n + min_chunk - 1) / min_chunk);
+	if (num_thread <= 1) {
+		body(0, n);
+		return;
+	}
+
+	vector<thread> threads;
+	size_t chunk = (n + num_thread - 1) / num_thread;
+	for (size_t begin = 0; begin < n; begin += chunk) {
+		threads.emplace_back(body, begin, min(n, begin + chunk));
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+}
+
+// 按查询数与线程数确定分段数（至多 hardware_concurrency 段）
+static size_t thread_parts(
+	size_t n,
+	int num_thread)
+{
+	size_t max_threads = max(1u, thread::hardware_concurrency());
+	size_t num_parts = min<size_t>(max(1, num_thread), max_threads);
+	return max<size_t>(1, min(num_parts, n));
+}
+
+// 将 [0, n) 均分为 num_parts 段，每段一个线程执行 body(段号, begin, end)
+static void parallel_parts(
+	size_t n,
+	size_t num_parts,
+	const function<void(size_t, size_t, size_t)>& body)
+{
+	if (num_parts <= 1) {
+		body(0, 0, n);
+		return;
+	}
+
+	vector<thread> threads;
+	size_t chunk = (n + num_parts - 1) / num_parts;
+	for (size_t part = 0; part < num_parts; ++part) {
+		threads.emplace_back(body, part, min(n, part * chunk), min(n, (part + 1) * chunk));
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+}
+
+// 扩展增量层的节点链表头（新增节点无基础边）
+static void grow_delta_nodes(
+	CSRGraph& g,
+	int num_nodes)
+{
+	if (num_nodes <= g.num_nodes && static_cast<int>(g.delta_out_head.size()) >= num_nodes) return;
+	g.num_nodes = max(g.num_nodes, num_nodes);
+	g.delta_out_head.resize(g.num_nodes, -1);
+	g.delta_in_head.resize(g.num_nodes, -1);
+}
+
+// 快照构建 ---------------------------------------------------------------------------------------
+// 构建CSR快照
+void GraphAlgorithms::freeze()
+{
+	thaw();
+
+	CSRGraph g;
+	g.version = graph_version;
+	g.layout_version = layout_version;
+	g.generation = csr.generation + 1;
+	g.num_nodes = static_cast<int>(node_ids.size());
+	g.num_base_nodes = g.num_nodes;
+
+	// 1.正向拓扑（仅非形心边，与 G 一致），行内按终点排序
+	vector<int> out_offset(g.num_nodes + 1, 0);
+	for (int u = 0; u < g.num_nodes; ++u) {
+		out_offset[u + 1] = out_offset[u] + static_cast<int>(G[u].size());
+	}
+	g.num_edges = out_offset[g.num_nodes];
+
+	vector<int> out_target(g.num_edges);
+	vector<int> edge_ids(g.num_edges);
+	vector<pair<int, int>> row;
+	for (int u = 0; u < g.num_nodes; ++u) {
+		row.clear();
+		for (const auto& edge : G[u]) {
+			row.emplace_back(edge.first, edge.second);
+		}
+		sort(row.begin(), row.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		int pos = out_offset[u];
+		for (const auto& item : row) {
+			out_target[pos] = item.first;
+			edge_ids[pos] = item.second;
+			pos++;
+		}
+	}
+
+	// 2.反向拓扑，in_edge 记录反向边对应的正向边位置
+	vector<int> in_offset(g.num_nodes + 1, 0);
+	for (int e = 0; e < g.num_edges; ++e) {
+		in_offset[out_target[e] + 1]++;
+	}
+	for (int i = 0; i < g.num_nodes; ++i) {
+		in_offset[i + 1] += in_offset[i];
+	}
+	vector<int> in_source(g.num_edges);
+	vector<int> in_edge(g.num_edges);
+	vector<int> cursor(in_offset.begin(), in_offset.end() - 1);
+	for (int u = 0; u < g.num_nodes; ++u) {
+		for (int e = out_offset[u]; e < out_offset[u + 1]; ++e) {
+			int pos = cursor[out_target[e]]++;
+			in_source[pos] = u;
+			in_edge[pos] = e;
+		}
+	}
+
+	g.out_offset = move(out_offset);
+	g.out_target = move(out_target);
+	g.in_offset = move(in_offset);
+	g.in_source = move(in_source);
+	g.edge_id = move(edge_ids);
+	g.in_edge = move(in_edge);
+	csr = move(g);
+
+	// 之后的非形心边增删进入增量层
+	vector<EdgeEdit>().swap(edge_log);
+	edge_log_enabled = true;
+
+	// 3.权重列惰性构建，仅常驻字段随快照重建
+	for (const auto& name : prepared_fields) {
+		get_weight_index(name);
+	}
+}
+
+
+// 获取CSR快照（少量增删边并入增量层，其余修改后整体重建）
+const CSRGraph& GraphAlgorithms::get_csr()
+{
+	finish_compact(false);
+	if (csr.version == graph_version) return csr;
+
+	// 1.布局变化（形心点、增删记录溢出）或增量层过大时整体重建
+	size_t delta_size = csr.delta_log.size() + edge_log.size();
+	if (csr.layout_version != layout_version || !edge_log_enabled ||
+		delta_size > max<size_t>(4096, static_cast<size_t>(csr.num_edges) / 4)) {
+		freeze();
+		return csr;
+	}
+
+	// 2.回放增删记录
+	for (const auto& edit : edge_log) {
+		apply_edge_edit(csr, edit);
+	}
+	edge_log.clear();
+	grow_delta_nodes(csr, static_cast<int>(node_ids.size()));
+	csr.version = graph_version;
+	return csr;
+}
+
+
+// 将一条增删记录并入快照的增量层
+void GraphAlgorithms::apply_edge_edit(
+	CSRGraph& g,
+	const EdgeEdit& edit)
+{
+	g.delta_log.push_back(edit);
+
+	// 1.删边：优先作废增量边，否则在基础边上打墓碑
+	if (edit.removed) {
+		int i = g.find_delta_edge(edit.from, edit.to);
+		if (i != -1) {
+			g.delta_edge[i] = -1;
+			return;
+		}
+		int e = g.find_base_edge(edit.from, edit.to);
+		if (e == -1) return;
+		if (g.out_dead.empty()) {
+			g.out_dead.assign((g.num_edges + 63) / 64, 0);
+			g.in_dead.assign((g.num_edges + 63) / 64, 0);
+		}
+		int r = g.find_base_in_edge(edit.from, edit.to);
+		g.out_dead[e >> 6] |= uint64_t(1) << (e & 63);
+		g.in_dead[r >> 6] |= uint64_t(1) << (r & 63);
+		g.num_dead++;
+		return;
+	}
+
+	// 2.加边：追加到增量层，挂到起点出链与终点入链表头
+	grow_delta_nodes(g, max(edit.from, edit.to) + 1);
+	int i = static_cast<int>(g.delta_to.size());
+	g.delta_from.push_back(edit.from);
+	g.delta_to.push_back(edit.to);
+	g.delta_edge.push_back(edit.edge);
+	g.delta_out_next.push_back(g.delta_out_head[edit.from]);
+	g.delta_out_head[edit.from] = i;
+	g.delta_in_next.push_back(g.delta_in_head[edit.to]);
+	g.delta_in_head[edit.to] = i;
+
+	// 已构建的权重列同步追加该边权重
+	g.delta_weight.resize(g.out_weight.size());
+	for (const auto& item : g.field_index) {
+		g.delta_weight[item.second].push_back(get_edge_weight(edit.edge, edge_attr.find(item.first)));
+	}
+}
+
+
+// 由快照副本生成合并增量层后的基础 CSR（不访问可变结构，可在后台线程执行）
+static CSRGraph merge_delta(
+	const CSRGraph& base)
+{
+	CSRGraph g;
+	g.version = base.version;
+	g.layout_version = base.layout_version;
+	g.generation = base.generation + 1;
+	g.num_nodes = base.num_nodes;
+	g.num_base_nodes = base.num_nodes;
+	g.field_index = base.field_index;
+	g.free_columns = base.free_columns;
+	size_t num_columns = base.out_weight.size();
+	vector<char> live(num_columns, 0); // 未释放的权重列
+	for (const auto& item : base.field_index) {
+		live[item.second] = 1;
+	}
+
+	// 1.正向拓扑：逐行合并存活的基础边与增量边，行内按终点排序
+	struct Item {
+		int target;
+		int edge;
+		int base_pos; // 基础边位置，增量边为 -1
+		int delta_pos; // 增量边序号
+	};
+	vector<int> out_offset(g.num_nodes + 1, 0);
+	vector<int> out_target, edge_ids;
+	vector<vector<weight_t>> out_w(num_columns);
+	vector<Item> row;
+	out_target.reserve(base.num_edges + base.delta_to.size());
+	edge_ids.reserve(out_target.capacity());
+	for (size_t c = 0; c < num_columns; ++c) {
+		if (live[c]) out_w[c].reserve(out_target.capacity());
+	}
+	for (int u = 0; u < g.num_nodes; ++u) {
+		row.clear();
+		if (u < base.num_base_nodes) {
+			for (int e = base.out_offset[u]; e < base.out_offset[u + 1]; ++e) {
+				if (base.num_dead != 0 && ((base.out_dead[e >> 6] >> (e & 63)) & 1)) continue;
+				row.push_back({ base.out_target[e], base.edge_id[e], e, -1 });
+			}
+		}
+		if (u < static_cast<int>(base.delta_out_head.size())) {
+			for (int i = base.delta_out_head[u]; i != -1; i = base.delta_out_next[i]) {
+				if (base.delta_edge[i] != -1) row.push_back({ base.delta_to[i], base.delta_edge[i], -1, i });
+			}
+		}
+		sort(row.begin(), row.end(), [](const Item& a, const Item& b) { return a.target < b.target; });
+		for (const auto& item : row) {
+			out_target.push_back(item.target);
+			edge_ids.push_back(item.edge);
+			for (size_t c = 0; c < num_columns; ++c) {
+				if (!live[c]) continue;
+				out_w[c].push_back(item.base_pos != -1 ? base.out_weight[c][item.base_pos] : base.delta_weight[c][item.delta_pos]);
+			}
+		}
+		out_offset[u + 1] = static_cast<int>(out_target.size());
+	}
+	g.num_edges = static_cast<int>(out_target.size());
+
+	// 2.反向拓扑与反向权重列
+	vector<int> in_offset(g.num_nodes + 1, 0);
+	for (int e = 0; e < g.num_edges; ++e) {
+		in_offset[out_target[e] + 1]++;
+	}
+	for (int i = 0; i < g.num_nodes; ++i) {
+		in_offset[i + 1] += in_offset[i];
+	}
+	vector<int> in_source(g.num_edges);
+	vector<int> in_edge(g.num_edges);
+	vector<int> cursor(in_offset.begin(), in_offset.end() - 1);
+	for (int u = 0; u < g.num_nodes; ++u) {
+		for (int e = out_offset[u]; e < out_offset[u + 1]; ++e) {
+			int pos = cursor[out_target[e]]++;
+			in_source[pos] = u;
+			in_edge[pos] = e;
+		}
+	}
+
+	g.out_weight.resize(num_columns);
+	g.in_weight.resize(num_columns);
+	for (size_t c = 0; c < num_columns; ++c) {
+		if (!live[c]) continue;
+		vector<weight_t> in_w(g.num_edges);
+		for (int e = 0; e < g.num_edges; ++e) {
+			in_w[e] = out_w[c][in_edge[e]];
+		}
+		g.out_weight[c] = move(out_w[c]);
+		g.in_weight[c] = move(in_w);
+	}
+
+	g.out_offset = move(out_offset);
+	g.out_target = move(out_target);
+	g.in_offset = move(in_offset);
+	g.in_source = move(in_source);
+	g.edge_id = move(edge_ids);
+	g.in_edge = move(in_edge);
+	return g;
+}
+
+
+// 将增量层合并为新的基础 CSR
+void GraphAlgorithms::compact(
+	bool wait)
+{
+	get_csr();
+	if (!compacting.valid() && csr.has_delta()) {
+		if (csr.edge_id.empty()) {
+			// 映射加载的快照没有边号，按可变结构同步重建
+			freeze();
+			return;
+		}
+
+		// 在快照副本上合并（只读列共享数据，增量层按值复制），期间的增删继续进入当前增量层
+		compact_generation = csr.generation;
+		compact_log_size = csr.delta_log.size();
+		compacting = async(launch::async, merge_delta, csr);
+	}
+	if (wait) finish_compact(true);
+}
+
+
+// 采用后台合并结果
+void GraphAlgorithms::finish_compact(
+	bool wait)
+{
+	if (!compacting.valid()) return;
+	if (!wait && compacting.wait_for(seconds(0)) != future_status::ready) return;
+
+	CSRGraph merged = compacting.get();
+	if (csr.generation != compact_generation) return; // 合并期间快照已整体重建，结果作废
+
+	// 回放合并开始之后的增删记录
+	for (size_t i = compact_log_size; i < csr.delta_log.size(); ++i) {
+		apply_edge_edit(merged, csr.delta_log[i]);
+	}
+	grow_delta_nodes(merged, csr.num_nodes);
+	merged.version = csr.version;
+	csr = move(merged);
+}
+
+
+// 获取权重列序号（未知字段视为全 1.0 权重）
+int GraphAlgorithms::get_weight_index(const string& weight_name)
+{
+	get_csr();
+
+	auto it = csr.field_index.find(weight_name);
+	if (it != csr.field_index.end()) {
+		return it->second;
+	}
+
+	// 新列须加入后台合并的结果，先等待合并完成
+	finish_compact(true);
+
+	// 1.构建权重列：缺失值按 1.0 处理
+	vector<weight_t> out_w, in_w;
+	ArrayRef<weight_t> out_column, in_column;
+	int f = edge_attr.find(weight_name);
+	if (f != -1 && edge_attr.count[f] > 0) {
+		if (image.active && !image.out_weight[f].empty()) {
+#ifdef GRAPHWORK_COMPACT
+			// 映射加载的快照：图像中的列为 double，转换为 float 副本
+			const auto& image_out = image.out_weight[f];
+			const auto& image_in = image.in_weight[f];
+			out_column = vector<weight_t>(image_out.begin(), image_out.end());
+			in_column = vector<weight_t>(image_in.begin(), image_in.end());
+#else
+			// 映射加载的快照：直接引用图像中的列
+			out_column = image.out_weight[f];
+			in_column = image.in_weight[f];
+#endif
+		}
+		else {
+			// 映射快照已重建可变结构但缺少边号时，先按可变结构重建快照
+			if (csr.edge_id.empty() && csr.num_edges > 0) {
+				freeze();
+				auto built = csr.field_index.find(weight_name);
+				if (built != csr.field_index.end()) return built->second;
+			}
+			build_weight_column(f, out_w, in_w);
+			out_column = move(out_w);
+			in_column = move(in_w);
+		}
+	}
+	else {
+		out_column = vector<weight_t>(csr.num_edges, 1.0);
+		in_column = vector<weight_t>(csr.num_edges, 1.0);
+	}
+
+	// 2.放入空闲列或追加
+	int index;
+	if (!csr.free_columns.empty()) {
+		index = csr.free_columns.back();
+		csr.free_columns.pop_back();
+		csr.out_weight[index] = out_column;
+		csr.in_weight[index] = in_column;
+	}
+	else {
+		index = static_cast<int>(csr.out_weight.size());
+		csr.out_weight.push_back(out_column);
+		csr.in_weight.push_back(in_column);
+	}
+	csr.field_index[weight_name] = index;
+
+	// 3.增量边权重
+	csr.delta_weight.resize(csr.out_weight.size());
+	auto& delta_w = csr.delta_weight[index];
+	delta_w.resize(csr.delta_edge.size());
+	for (size_t i = 0; i < delta_w.size(); ++i) {
+		delta_w[i] = csr.delta_edge[i] == -1 ? 1.0 : get_edge_weight(csr.delta_edge[i], f);
+	}
+	return index;
+}
+
+
+// 按边号收集字段 f 的正反向权重列（大图分段并行）
+void GraphAlgorithms::build_weight_column(
+	int f,
+	vector<weight_t>& out_w,
+	vector<weight_t>& in_w)
+{
+	const CSRGraph& g = csr;
+	out_w.resize(g.num_edges);
+	in_w.resize(g.num_edges);
+
+	parallel_ranges(g.num_edges, [&](size_t begin, size_t end) {
+		for (size_t e = begin; e < end; ++e) {
+			out_w[e] = get_edge_weight(g.edge_id[e], f);
+		}
+	});
+	parallel_ranges(g.num_edges, [&](size_t begin, size_t end) {
+		for (size_t e = begin; e < end; ++e) {
+			in_w[e] = out_w[g.in_edge[e]];
+		}
+	});
+}
+
+
+// 预构建权重列
+void GraphAlgorithms::prepare_weight(
+	const string& weight_name)
+{
+	prepared_fields.insert(weight_name);
+	get_weight_index(weight_name);
+}
+
+
+// 释放权重列
+void GraphAlgorithms::drop_weight(
+	const string& weight_name)
+{
+	prepared_fields.erase(weight_name);
+	finish_compact(true);
+
+	auto it = csr.field_index.find(weight_name);
+	if (it == csr.field_index.end()) return;
+	csr.out_weight[it->second] = ArrayRef<weight_t>();
+	csr.in_weight[it->second] = ArrayRef<weight_t>();
+	if (it->second < static_cast<int>(csr.delta_weight.size())) vector<weight_t>().swap(csr.delta_weight[it->second]);
+	if (it->second < static_cast<int>(chains.graph.out_weight.size())) {
+		chains.graph.out_weight[it->second] = ArrayRef<weight_t>();
+		chains.graph.in_weight[it->second] = ArrayRef<weight_t>();
+	}
+	csr.free_columns.push_back(it->second);
+	csr.field_index.erase(it);
+}
+
+
+// 统计内存用量（含CSR快照、权重列与增量层）
+void GraphAlgorithms::collect_memory_usage(
+	MemoryUsage& usage) const
+{
+	CGraph::collect_memory_usage(usage);
+	const CSRGraph& g = csr;
+
+	// 1.拓扑与边号（映射加载的部分计入 mapped）
+	usage.add("csr_topology", usage.array_bytes(g.out_offset) + usage.array_bytes(g.out_target) +
+		usage.array_bytes(g.in_offset) + usage.array_bytes(g.in_source) +
+		usage.array_bytes(g.edge_id) + usage.array_bytes(g.in_edge));
+
+	// 2.按字段缓存的权重列
+	size_t weights = hash_table_bytes(g.field_index) + vector_bytes(g.out_weight) + vector_bytes(g.in_weight) +
+		vector_bytes(g.free_columns) + vector_bytes(g.delta_weight);
+	for (const auto& item : g.field_index) weights += string_bytes(item.first);
+	for (size_t c = 0; c < g.out_weight.size(); ++c) {
+		weights += usage.array_bytes(g.out_weight[c]) + usage.array_bytes(g.in_weight[c]);
+	}
+	for (const auto& column : g.delta_weight) weights += vector_bytes(column);
+	for (const auto& name : prepared_fields) weights += heap_block_bytes(4 * sizeof(void*) + sizeof(string)) + string_bytes(name);
+	usage.add("csr_weights", weights);
+
+	// 3.增量层
+	usage.add("csr_delta", vector_bytes(g.delta_log) + vector_bytes(g.delta_from) + vector_bytes(g.delta_to) +
+		vector_bytes(g.delta_edge) + vector_bytes(g.delta_out_head) + vector_bytes(g.delta_out_next) +
+		vector_bytes(g.delta_in_head) + vector_bytes(g.delta_in_next) + vector_bytes(g.out_dead) + vector_bytes(g.in_dead));
+
+	// 4.链收缩
+	const ChainIndex& c = chains;
+	size_t chain_bytes = vector_bytes(c.interior) + vector_bytes(c.base_pos) + vector_bytes(c.shortcut) +
+		vector_bytes(c.chain_from) + vector_bytes(c.from_offset) + vector_bytes(c.chain_offset) + vector_bytes(c.chain_nodes) + vector_bytes(c.chain_pos) +
+		usage.array_bytes(c.graph.out_offset) + usage.array_bytes(c.graph.out_target) +
+		usage.array_bytes(c.graph.in_offset) + usage.array_bytes(c.graph.in_source) + usage.array_bytes(c.graph.in_edge) +
+		vector_bytes(c.graph.out_weight) + vector_bytes(c.graph.in_weight);
+	for (size_t i = 0; i < c.graph.out_weight.size(); ++i) {
+		chain_bytes += usage.array_bytes(c.graph.out_weight[i]) + usage.array_bytes(c.graph.in_weight[i]);
+	}
+	usage.add("chains", chain_bytes);
+
+	// 5.空间索引
+	usage.add("spatial", vector_bytes(spatial.node_offset) + vector_bytes(spatial.node_items) +
+		vector_bytes(spatial.edge_offset) + vector_bytes(spatial.edge_items));
+
+	// 6.路标索引
+	size_t landmark_bytes = 0;
+	for (const auto& item : alt_index) {
+		landmark_bytes += vector_bytes(item.second.landmarks) + vector_bytes(item.second.from) + vector_bytes(item.second.to);
+	}
+	usage.add("landmarks", landmark_bytes);
+
+	// 7.收缩层次
+	size_t ch_bytes = 0;
+	for (const auto& item : ch_index) {
+		const ContractionHierarchy& h = item.second;
+		ch_bytes += vector_bytes(h.rank) + vector_bytes(h.order) +
+			vector_bytes(h.up_offset) + vector_bytes(h.up_target) + vector_bytes(h.up_weight) + vector_bytes(h.up_middle) +
+			vector_bytes(h.down_offset) + vector_bytes(h.down_source) + vector_bytes(h.down_weight) + vector_bytes(h.down_middle) +
+			vector_bytes(h.sweep_offset) + vector_bytes(h.sweep_source) + vector_bytes(h.sweep_weight);
+	}
+	usage.add("ch", ch_bytes);
+
+	// 8.多层覆盖图
+	size_t overlay_bytes = 0;
+	for (const auto& level : overlay.levels) {
+		overlay_bytes += vector_bytes(level.cell) + vector_bytes(level.entry_offset) + vector_bytes(level.entries) +
+			vector_bytes(level.exit_offset) + vector_bytes(level.exits) + vector_bytes(level.entry_pos) +
+			vector_bytes(level.exit_pos) + vector_bytes(level.clique_offset);
+	}
+	for (const auto& item : overlay_metric) {
+		for (const auto& clique : item.second.clique) overlay_bytes += vector_bytes(clique);
+	}
+	usage.add("overlay", overlay_bytes);
+
+	// 9.本进程发布的共享内存段
+	if (published) usage.mapped += published->size();
+}
+
+
+// 权重更新 ---------------------------------------------------------------------------------------
+// 批量原地修改边权重：属性列与已缓存的正反向权重列同步更新，拓扑与快照不重建
+int GraphAlgorithms::update_edge_weights(
+	const py::array& u_,
+	const py::array& v_,
+	const py::array& values_,
+	const string& field)
+{
+	// 1.一次性校验 dtype 与长度
+	ArrayView u(u_, "u", false);
+	ArrayView v(v_, "v", false);
+	ArrayView values(values_, "values", true);
+	py::ssize_t n = u_.size();
+	if (v_.size() != n || values_.size() != n) {
+		throw runtime_error("'u', 'v' and 'values' must have the same length");
+	}
+
+	thaw();
+	finish_compact(true); // 后台合并共享权重列数据，原地修改前先完成合并
+	const CSRGraph& g = get_csr();
+	int f = intern_field(field);
+
+	// 2.已缓存的权重列：映射区域只读，首次修改时复制为自有数据
+	weight_t* out_w = nullptr;
+	weight_t* in_w = nullptr;
+	weight_t* delta_w = nullptr;
+	auto column_it = csr.field_index.find(field);
+	if (column_it != csr.field_index.end()) {
+		auto& out_column = csr.out_weight[column_it->second];
+		auto& in_column = csr.in_weight[column_it->second];
+		if (out_column.mutable_data() == nullptr) out_column = vector<weight_t>(out_column.begin(), out_column.end());
+		if (in_column.mutable_data() == nullptr) in_column = vector<weight_t>(in_column.begin(), in_column.end());
+		out_w = out_column.mutable_data();
+		in_w = in_column.mutable_data();
+		delta_w = csr.delta_weight.empty() ? nullptr : csr.delta_weight[column_it->second].data();
+	}
+
+	// 3.释放 GIL 逐条更新：边号经哈希邻接 O(1) 定位，快照位置在行内二分（行内有序）
+	py::gil_scoped_release release;
+
+	int updated = 0;
+	for (py::ssize_t i = 0; i < n; ++i) {
+		double value = values.get_double(i);
+		if (std::isnan(value)) continue;
+		int o = find_node(static_cast<int>(u.get_int(i)));
+		int d = find_node(static_cast<int>(v.get_int(i)));
+		if (o == -1 || d == -1) continue;
+
+		auto g_it = G[o].find(d);
+		if (g_it != G[o].end()) {
+			set_edge_attr(g_it->second, f, value);
+			if (out_w != nullptr) {
+				int pos = g.find_base_edge(o, d);
+				if (pos != -1) {
+					out_w[pos] = value;
+					in_w[g.find_base_in_edge(o, d)] = value;
+				}
+				else {
+					delta_w[g.find_delta_edge(o, d)] = value;
+				}
+			}
+			updated++;
+			continue;
+		}
+
+		// 形心边不在快照中，只更新属性列
+		int e = find_edge(o, d);
+		if (e == -1) continue;
+		set_edge_attr(e, f, value);
+		updated++;
+	}
+
+	// 没有边被修改时保留各派生索引
+	if (updated > 0) weight_version++;
+	return updated;
+}
+
+
+// 节点重排 ---------------------------------------------------------------------------------------
+// 无向邻接（按边表，含形心边，去重、行内升序），offset 长度 num_nodes + 1
+static void undirected_adjacency(
+	int num_nodes,
+	const vector<int>& edge_from,
+	const vector<int>& edge_to,
+	vector<int>& offset,
+	vector<int>& adj)
+{
+	offset.assign(num_nodes + 1, 0);
+	for (size_t e = 0; e < edge_from.size(); ++e) {
+		if (edge_to[e] == -1 || edge_from[e] == edge_to[e]) continue;
+		offset[edge_from[e] + 1]++;
+		offset[edge_to[e] + 1]++;
+	}
+	for (int u = 0; u < num_nodes; ++u) {
+		offset[u + 1] += offset[u];
+	}
+	adj.resize(offset[num_nodes]);
+	vector<int> cursor(offset.begin(), offset.end() - 1);
+	for (size_t e = 0; e < edge_from.size(); ++e) {
+		if (edge_to[e] == -1 || edge_from[e] == edge_to[e]) continue;
+		adj[cursor[edge_from[e]]++] = edge_to[e];
+		adj[cursor[edge_to[e]]++] = edge_from[e];
+	}
+
+	// 双向边在两个方向各出现一次，去重后压缩
+	int write = 0;
+	for (int u = 0; u < num_nodes; ++u) {
+		int begin = offset[u];
+		int end = offset[u + 1];
+		sort(adj.begin() + begin, adj.begin() + end);
+		offset[u] = write;
+		for (int i = begin; i < end; ++i) {
+			if (i == begin || adj[i] != adj[i - 1]) adj[write++] = adj[i];
+		}
+	}
+	offset[num_nodes] = write;
+	adj.resize(write);
+}
+
+
+// 广度优先序：各连通分量依次从其中度最小的节点出发
+static vector<int> bfs_order(
+	const vector<int>& offset,
+	const vector<int>& adj)
+{
+	int num_nodes = static_cast<int>(offset.size()) - 1;
+	vector<int> starts(num_nodes);
+	for (int u = 0; u < num_nodes; ++u) starts[u] = u;
+	stable_sort(starts.begin(), starts.end(), [&](int a, int b) {
+		return offset[a + 1] - offset[a] < offset[b + 1] - offset[b];
+	});
+
+	vector<int> order;
+	order.reserve(num_nodes);
+	vector<char> visited(num_nodes, 0);
+	for (int s : starts) {
+		if (visited[s]) continue;
+		size_t head = order.size();
+		visited[s] = 1;
+		order.push_back(s);
+		for (; head < order.size(); ++head) {
+			int u = order[head];
+			for (int i = offset[u]; i < offset[u + 1]; ++i) {
+				if (!visited[adj[i]]) {
+					visited[adj[i]] = 1;
+					order.push_back(adj[i]);
+				}
+			}
+		}
+	}
+	return order;
+}
+
+
+// 逆 Cuthill-McKee 序：各分量从伪外围节点出发广度优先，邻居按度升序入队，最后整体反转
+static vector<int> rcm_order(
+	const vector<int>& offset,
+	const vector<int>& adj)
+{
+	int num_nodes = static_cast<int>(offset.size()) - 1;
+	auto degree = [&](int u) { return offset[u + 1] - offset[u]; };
+
+	vector<int> starts(num_nodes);
+	for (int u = 0; u < num_nodes; ++u) starts[u] = u;
+	stable_sort(starts.begin(), starts.end(), [&](int a, int b) { return degree(a) < degree(b); });
+
+	// 分量内广度优先分层，返回最后一层中度最小的节点与层数（mark 为本次遍历的标记值）
+	vector<int> level_mark(num_nodes, -1);
+	vector<int> queue;
+	int mark = 0;
+	auto farthest = [&](int s, int& depth) {
+		mark++;
+		queue.clear();
+		queue.push_back(s);
+		level_mark[s] = mark;
+		size_t level_begin = 0;
+		depth = 0;
+		while (true) {
+			size_t level_end = queue.size();
+			for (size_t i = level_begin; i < level_end; ++i) {
+				int u = queue[i];
+				for (int k = offset[u]; k < offset[u + 1]; ++k) {
+					if (level_mark[adj[k]] != mark) {
+						level_mark[adj[k]] = mark;
+						queue.push_back(adj[k]);
+					}
+				}
+			}
+			if (queue.size() == level_end) {
+				int best = queue[level_begin];
+				for (size_t i = level_begin; i < level_end; ++i) {
+					if (degree(queue[i]) < degree(best)) best = queue[i];
+				}
+				return best;
+			}
+			level_begin = level_end;
+			depth++;
+		}
+	};
+
+	vector<int> order;
+	order.reserve(num_nodes);
+	vector<char> visited(num_nodes, 0);
+	vector<int> neighbors;
+	for (int s : starts) {
+		if (visited[s]) continue;
+
+		// 1.伪外围节点：反复取最远层的最小度节点，直到层数不再增加
+		int depth = 0;
+		int next_depth = 0;
+		int next = farthest(s, depth);
+		for (int iter = 0; iter < 8; ++iter) {
+			int candidate = farthest(next, next_depth);
+			if (next_depth <= depth) break;
+			s = next;
+			next = candidate;
+			depth = next_depth;
+		}
+
+		// 2.Cuthill-McKee 广度优先
+		size_t head = order.size();
+		visited[s] = 1;
+		order.push_back(s);
+		for (; head < order.size(); ++head) {
+			int u = order[head];
+			neighbors.clear();
+			for (int k = offset[u]; k < offset[u + 1]; ++k) {
+				if (!visited[adj[k]]) {
+					visited[adj[k]] = 1;
+					neighbors.push_back(adj[k]);
+				}
+			}
+			stable_sort(neighbors.begin(), neighbors.end(), [&](int a, int b) { return degree(a) < degree(b); });
+			order.insert(order.end(), neighbors.begin(), neighbors.end());
+		}
+	}
+	reverse(order.begin(), order.end());
+	return order;
+}
+
+
+// Hilbert 曲线上的位置（x、y 为 [0, 2^16) 网格坐标）
+static uint64_t hilbert_key(
+	uint32_t x,
+	uint32_t y)
+{
+	const uint32_t n = 1u << 16;
+	uint64_t d = 0;
+	for (uint32_t s = n / 2; s > 0; s /= 2) {
+		uint32_t rx = (x & s) > 0;
+		uint32_t ry = (y & s) > 0;
+		d += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+		// 旋转象限
+		if (ry == 0) {
+			if (rx == 1) {
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			swap(x, y);
+		}
+	}
+	return d;
+}
+
+
+// Hilbert 曲线序：有坐标的节点按坐标包围盒映射到 2^16 网格后排序，无坐标的节点保持原顺序排在最后
+static vector<int> hilbert_order(
+	const vector<double>& node_x,
+	const vector<double>& node_y)
+{
+	int num_nodes = static_cast<int>(node_x.size());
+	double min_x = numeric_limits<double>::infinity(), max_x = -min_x;
+	double min_y = min_x, max_y = max_x;
+	for (int u = 0; u < num_nodes; ++u) {
+		if (std::isnan(node_x[u]) || std::isnan(node_y[u])) continue;
+		min_x = min(min_x, node_x[u]);
+		max_x = max(max_x, node_x[u]);
+		min_y = min(min_y, node_y[u]);
+		max_y = max(max_y, node_y[u]);
+	}
+
+	const double grid = 65535.0;
+	double scale_x = max_x > min_x ? grid / (max_x - min_x) : 0.0;
+	double scale_y = max_y > min_y ? grid / (max_y - min_y) : 0.0;
+	vector<pair<uint64_t, int>> keyed;
+	vector<int> missing;
+	keyed.reserve(num_nodes);
+	for (int u = 0; u < num_nodes; ++u) {
+		if (std::isnan(node_x[u]) || std::isnan(node_y[u])) {
+			missing.push_back(u);
+			continue;
+		}
+		uint32_t gx = static_cast<uint32_t>((node_x[u] - min_x) * scale_x);
+		uint32_t gy = static_cast<uint32_t>((node_y[u] - min_y) * scale_y);
+		keyed.emplace_back(hilbert_key(gx, gy), u);
+	}
+	sort(keyed.begin(), keyed.end());
+
+	vector<int> order;
+	order.reserve(num_nodes);
+	for (const auto& item : keyed) order.push_back(item.second);
+	order.insert(order.end(), missing.begin(), missing.end());
+	return order;
+}
+
+
+// 按局部性重排内部索引并重建快照
+void GraphAlgorithms::reorder_nodes(
+	const string& method)
+{
+	thaw();
+	int num_nodes = static_cast<int>(node_ids.size());
+
+	vector<int> order;
+	if (method == "BFS" || method == "RCM") {
+		vector<int> offset, adj;
+		undirected_adjacency(num_nodes, edge_from, edge_to, offset, adj);
+		order = method == "BFS" ? bfs_order(offset, adj) : rcm_order(offset, adj);
+	}
+	else if (method == "Hilbert") {
+		if (node_x.empty()) {
+			throw runtime_error("Hilbert order requires node coordinates, call set_node_coords first");
+		}
+		order = hilbert_order(node_x, node_y);
+	}
+	else {
+		throw runtime_error("unknown node order '" + method + "', expected 'BFS', 'RCM' or 'Hilbert'");
+	}
+
+	permute_nodes(order);
+	freeze();
+}
+
+
+// 链收缩 -----------------------------------------------------------------------------------------
+// 启用或关闭度为 2 的链收缩
+void GraphAlgorithms::contract_chains(
+	bool enable)
+{
+	if (!enable) {
+		chains = ChainIndex();
+		return;
+	}
+	build_chains();
+}
+
+
+// 按当前快照构建收缩图
+void GraphAlgorithms::build_chains()
+{
+	get_csr();
+	if (csr.has_delta()) compact(true);
+	const CSRGraph& g = csr;
+	int n = g.num_nodes;
+
+	ChainIndex c;
+	c.enabled = true;
+	c.version = g.version;
+	c.generation = g.generation;
+
+	// 1.候选内部节点：非形心点、不与形心边相连，且只与两个不同邻点相连（单向 p->x->q 或双向 p<->x<->q）
+	vector<char> pinned(n, 0);
+	for (const auto* container : { &m_centroid_start_map, &m_centroid_end_map }) {
+		for (const auto& row : *container) {
+			pinned[row.first] = 1;
+			for (const auto& item : row.second) pinned[item.first] = 1;
+		}
+	}
+	c.interior.assign(n, 0);
+	for (int u = 0; u < g.num_base_nodes; ++u) {
+		if (pinned[u] || is_centroid(u)) continue;
+		int out_n = g.out_offset[u + 1] - g.out_offset[u];
+		int in_n = g.in_offset[u + 1] - g.in_offset[u];
+		const int* out = g.out_target.begin() + g.out_offset[u];
+		const int* in = g.in_source.begin() + g.in_offset[u];
+		if (out_n == 1 && in_n == 1) {
+			c.interior[u] = out[0] != in[0] && out[0] != u && in[0] != u;
+		}
+		else if (out_n == 2 && in_n == 2) {
+			c.interior[u] = out[0] == in[0] && out[1] == in[1] && out[0] != u && out[1] != u; // 行内均有序
+		}
+	}
+
+	// 2.从非内部节点出发沿链行走生成捷径；成环、与已有边或其他捷径重复的链以及未被覆盖的内部节点恢复为普通节点，直至稳定
+	vector<int> chain_to;
+	while (true) {
+		c.chain_from.clear();
+		c.chain_offset.assign(1, 0);
+		c.chain_nodes.clear();
+		c.chain_pos.clear();
+		chain_to.clear();
+		vector<char> covered(n, 0);
+
+		for (int a = 0; a < g.num_base_nodes; ++a) {
+			if (c.interior[a]) continue;
+			for (int e = g.out_offset[a]; e < g.out_offset[a + 1]; ++e) {
+				int cur = g.out_target[e];
+				if (!c.interior[cur]) continue;
+
+				// 内部节点只有一个不回头的后继
+				int prev = a;
+				c.chain_pos.push_back(e);
+				while (c.interior[cur]) {
+					c.chain_nodes.push_back(cur);
+					covered[cur] = 1;
+					int next = g.out_offset[cur];
+					if (g.out_target[next] == prev && g.out_offset[cur + 1] - next == 2) next++;
+					c.chain_pos.push_back(next);
+					prev = cur;
+					cur = g.out_target[next];
+				}
+				c.chain_from.push_back(a);
+				chain_to.push_back(cur);
+				c.chain_offset.push_back(static_cast<int>(c.chain_nodes.size()));
+			}
+		}
+
+		// 同起终点的捷径只保留一条，与原始边重复或成环的捷径放弃
+		int num_chains = c.num_chains();
+		vector<int> order(num_chains);
+		for (int s = 0; s < num_chains; ++s) order[s] = s;
+		sort(order.begin(), order.end(), [&](int x, int y) {
+			return make_pair(c.chain_from[x], chain_to[x]) < make_pair(c.chain_from[y], chain_to[y]);
+		});
+		bool changed = false;
+		for (size_t i = 0; i < order.size(); ++i) {
+			int s = order[i];
+			bool duplicate = i > 0 && c.chain_from[order[i - 1]] == c.chain_from[s] && chain_to[order[i - 1]] == chain_to[s];
+			if (!duplicate && c.chain_from[s] != chain_to[s] && g.find_base_edge(c.chain_from[s], chain_to[s]) == -1) continue;
+			for (int j = c.chain_offset[s]; j < c.chain_offset[s + 1]; ++j) {
+				c.interior[c.chain_nodes[j]] = 0;
+			}
+			changed = true;
+		}
+		for (int u = 0; u < n; ++u) {
+			if (c.interior[u] && !covered[u]) {
+				c.interior[u] = 0;
+				changed = true;
+			}
+		}
+		if (!changed) break;
+	}
+	c.from_offset.assign(n + 1, 0);
+	for (int a : c.chain_from) c.from_offset[a + 1]++;
+	for (int u = 0; u < n; ++u) c.from_offset[u + 1] += c.from_offset[u];
+
+	// 3.收缩图正向拓扑：非内部节点之间的原始边 + 捷径（捷径按起点升序生成），行内按终点排序
+	struct Item {
+		int target;
+		int base_pos; // 快照位置，捷径为 -1
+		int shortcut; // 捷径序号，原始边为 -1
+	};
+	CSRGraph& r = c.graph;
+	r.version = g.version;
+	r.generation = g.generation;
+	r.num_nodes = n;
+	r.num_base_nodes = n;
+
+	vector<int> out_offset(n + 1, 0);
+	vector<int> out_target;
+	vector<Item> row;
+	int next_chain = 0;
+	for (int u = 0; u < n; ++u) {
+		row.clear();
+		if (!c.interior[u] && u < g.num_base_nodes) {
+			for (int e = g.out_offset[u]; e < g.out_offset[u + 1]; ++e) {
+				if (!c.interior[g.out_target[e]]) row.push_back({ g.out_target[e], e, -1 });
+			}
+		}
+		for (; next_chain < c.num_chains() && c.chain_from[next_chain] == u; ++next_chain) {
+			row.push_back({ chain_to[next_chain], -1, next_chain });
+		}
+		sort(row.begin(), row.end(), [](const Item& a, const Item& b) { return a.target < b.target; });
+		for (const auto& item : row) {
+			out_target.push_back(item.target);
+			c.base_pos.push_back(item.base_pos);
+			c.shortcut.push_back(item.shortcut);
+		}
+		out_offset[u + 1] = static_cast<int>(out_target.size());
+	}
+	r.num_edges = static_cast<int>(out_target.size());
+
+	// 4.反向拓扑
+	vector<int> in_offset(n + 1, 0);
+	for (int e = 0; e < r.num_edges; ++e) {
+		in_offset[out_target[e] + 1]++;
+	}
+	for (int i = 0; i < n; ++i) {
+		in_offset[i + 1] += in_offset[i];
+	}
+	vector<int> in_source(r.num_edges);
+	vector<int> in_edge(r.num_edges);
+	vector<int> cursor(in_offset.begin(), in_offset.end() - 1);
+	for (int u = 0; u < n; ++u) {
+		for (int e = out_offset[u]; e < out_offset[u + 1]; ++e) {
+			int pos = cursor[out_target[e]]++;
+			in_source[pos] = u;
+			in_edge[pos] = e;
+		}
+	}
+	r.out_offset = move(out_offset);
+	r.out_target = move(out_target);
+	r.in_offset = move(in_offset);
+	r.in_source = move(in_source);
+	r.in_edge = move(in_edge);
+
+	chains = move(c);
+}
+
+
+// 选择路由所用的图
+const CSRGraph& GraphAlgorithms::route_graph(
+	const vector<int>& nodes,
+	const string& weight_name,
+	int& weight_index)
+{
+	if (!chains.enabled) return csr;
+
+	// 1.快照变化后重建收缩图（先合并增量层，列序号可能随之变化）
+	if (csr.has_delta()) {
+		compact(true);
+		weight_index = get_weight_index(weight_name);
+	}
+	if (chains.generation != csr.generation || chains.version != csr.version) {
+		build_chains();
+	}
+
+	// 2.端点位于链内部时在原快照上搜索
+	for (int u : nodes) {
+		if (u >= 0 && u < static_cast<int>(chains.interior.size()) && chains.interior[u]) return csr;
+	}
+
+	// 3.收缩图权重列：与快照列序号一致，首次使用时由快照列求和构建，权重原地修改后整体失效
+	CSRGraph& r = chains.graph;
+	if (chains.weight_version != weight_version) {
+		r.out_weight.clear();
+		r.in_weight.clear();
+		chains.weight_version = weight_version;
+	}
+	r.out_weight.resize(csr.out_weight.size());
+	r.in_weight.resize(csr.in_weight.size());
+	if (r.out_weight[weight_index].empty() && r.num_edges > 0) {
+		const auto& base_w = csr.out_weight[weight_index];
+		vector<weight_t> out_w(r.num_edges);
+		vector<weight_t> in_w(r.num_edges);
+		for (int p = 0; p < r.num_edges; ++p) {
+			int s = chains.shortcut[p];
+			if (s == -1) {
+				out_w[p] = base_w[chains.base_pos[p]];
+				continue;
+			}
+			double sum = 0.0;
+			int pos_begin = chains.chain_offset[s] + s;
+			int pos_end = chains.chain_offset[s + 1] + s + 1;
+			for (int j = pos_begin; j < pos_end; ++j) {
+				sum += base_w[chains.chain_pos[j]];
+			}
+			out_w[p] = static_cast<weight_t>(sum);
+		}
+		for (int p = 0; p < r.num_edges; ++p) {
+			in_w[p] = out_w[r.in_edge[p]];
+		}
+		r.out_weight[weight_index] = move(out_w);
+		r.in_weight[weight_index] = move(in_w);
+	}
+	return r;
+}
+
+
+// 收缩图上的路径展开为原图路径
+vector<int> GraphAlgorithms::expand_path(
+	const vector<int>& path) const
+{
+	if (path.size() < 2) return path;
+
+	vector<int> full;
+	full.reserve(path.size());
+	full.push_back(path[0]);
+	for (size_t i = 1; i < path.size(); ++i) {
+		int p = chains.graph.find_base_edge(path[i - 1], path[i]);
+		int s = p == -1 ? -1 : chains.shortcut[p];
+		if (s != -1) {
+			full.insert(full.end(), chains.chain_nodes.begin() + chains.chain_offset[s], chains.chain_nodes.begin() + chains.chain_offset[s + 1]);
+		}
+		full.push_back(path[i]);
+	}
+	return full;
+}
+
+
+// 收缩图上的搜索结果补全链内部节点
+void GraphAlgorithms::expand_result(
+	SearchResult& result,
+	int weight_index,
+	double cut_off) const
+{
+	const auto& weight = csr.out_weight[weight_index];
+	SearchWorkspace& ws = *result.workspace;
+
+	// 1.经捷径到达的节点，前驱改为链上最后一个内部节点，其所在的链优先补全
+	vector<int> order;
+	for (int v : result.touched) {
+		int u = ws.pred[v];
+		if (u == -1) continue;
+		int p = chains.graph.find_base_edge(u, v);
+		int s = p == -1 ? -1 : chains.shortcut[p];
+		if (s == -1) continue;
+		ws.pred[v] = chains.chain_nodes[chains.chain_offset[s + 1] - 1];
+		order.push_back(s);
+	}
+	sort(order.begin(), order.end());
+	order.erase(unique(order.begin(), order.end()), order.end());
+
+	// 其余只补全起点已到达的链（链起点均不是内部节点，补全过程中新到达的节点无需再看）
+	size_t num_used = order.size();
+	size_t num_touched = result.touched.size();
+	for (size_t i = 0; i < num_touched; ++i) {
+		int a = result.touched[i];
+		for (int s = chains.from_offset[a]; s < chains.from_offset[a + 1]; ++s) {
+			if (!binary_search(order.begin(), order.begin() + num_used, s)) order.push_back(s);
+		}
+	}
+
+	// 2.内部节点的花费为链起点花费加链上前缀权重（双向链取两个方向的较小者），前驱为链上前一节点
+	for (int s : order) {
+		int a = chains.chain_from[s];
+		double d = result.dist(a);
+		if (d == numeric_limits<double>::infinity()) continue;
+
+		int node_begin = chains.chain_offset[s];
+		int pos_begin = node_begin + s;
+		for (int j = node_begin; j < chains.chain_offset[s + 1]; ++j) {
+			d += weight[chains.chain_pos[pos_begin + (j - node_begin)]];
+			if (d > cut_off) break;
+			int x = chains.chain_nodes[j];
+			if (d >= result.dist(x)) continue;
+			if (!ws.reached(x)) result.touched.push_back(x);
+			ws.set(x, d, j == node_begin ? a : chains.chain_nodes[j - 1]);
+		}
+	}
+}
+
+
+// 空间索引 ---------------------------------------------------------------------------------------
+// 获取空间索引（坐标或图修改后重建）
+const SpatialGrid& GraphAlgorithms::get_spatial()
+{
+	thaw();
+	if (spatial.graph_version == graph_version && spatial.coord_version == coord_version) return spatial;
+	if (node_x.empty()) {
+		throw runtime_error("node coordinates are not set, call set_node_coords first");
+	}
+
+	SpatialGrid grid;
+	grid.graph_version = graph_version;
+	grid.coord_version = coord_version;
+	int num_nodes = static_cast<int>(node_ids.size());
+
+	// 1.参与索引的节点（有坐标且不是形心点）与包围盒
+	vector<char> indexed(num_nodes, 0);
+	int num_indexed = 0;
+	double max_x = -numeric_limits<double>::infinity();
+	double max_y = max_x;
+	grid.min_x = numeric_limits<double>::infinity();
+	grid.min_y = grid.min_x;
+	for (int u = 0; u < num_nodes; ++u) {
+		if (!has_coord(u) || is_centroid(u)) continue;
+		indexed[u] = 1;
+		num_indexed++;
+		grid.min_x = min(grid.min_x, node_x[u]);
+		grid.min_y = min(grid.min_y, node_y[u]);
+		max_x = max(max_x, node_x[u]);
+		max_y = max(max_y, node_y[u]);
+	}
+	if (num_indexed == 0) {
+		grid.min_x = grid.min_y = 0.0;
+		grid.node_offset.assign(1, 0);
+		grid.edge_offset.assign(1, 0);
+		spatial = move(grid);
+		return spatial;
+	}
+
+	// 2.单元边长：平均每个单元约 2 个节点（节点共线时按长边均分）
+	double width = max_x - grid.min_x;
+	double height = max_y - grid.min_y;
+	if (width > 0 && height > 0) grid.cell = sqrt(width * height * 2.0 / num_indexed);
+	else if (width > 0 || height > 0) grid.cell = max(width, height) * 2.0 / num_indexed;
+	grid.cols = static_cast<int>(width / grid.cell) + 1;
+	grid.rows = static_cast<int>(height / grid.cell) + 1;
+	int num_cells = grid.cols * grid.rows;
+
+	// 3.节点按单元计数排序
+	grid.node_offset.assign(num_cells + 1, 0);
+	for (int u = 0; u < num_nodes; ++u) {
+		if (indexed[u]) grid.node_offset[grid.row_of(node_y[u]) * grid.cols + grid.col_of(node_x[u]) + 1]++;
+	}
+	for (int c = 0; c < num_cells; ++c) {
+		grid.node_offset[c + 1] += grid.node_offset[c];
+	}
+	grid.node_items.resize(num_indexed);
+	vector<int> cursor(grid.node_offset.begin(), grid.node_offset.end() - 1);
+	for (int u = 0; u < num_nodes; ++u) {
+		if (indexed[u]) grid.node_items[cursor[grid.row_of(node_y[u]) * grid.cols + grid.col_of(node_x[u])]++] = u;
+	}
+
+	// 4.两端均参与索引的边，登记到线段经过的各单元（逐列求线段在该列内的 y 区间；先计数再填充）
+	auto for_each_cell = [&](int e, const function<void(int)>& visit) {
+		double ax = node_x[edge_from[e]];
+		double ay = node_y[edge_from[e]];
+		double bx = node_x[edge_to[e]];
+		double by = node_y[edge_to[e]];
+		if (ax > bx) {
+			swap(ax, bx);
+			swap(ay, by);
+		}
+		int c0 = grid.col_of(ax);
+		int c1 = grid.col_of(bx);
+		for (int c = c0; c <= c1; ++c) {
+			double y0 = ay;
+			double y1 = by;
+			if (c0 != c1) {
+				double slope = (by - ay) / (bx - ax);
+				double x0 = max(ax, grid.min_x + c * grid.cell);
+				double x1 = min(bx, grid.min_x + (c + 1) * grid.cell);
+				y0 = ay + (x0 - ax) * slope;
+				y1 = ay + (x1 - ax) * slope;
+			}
+			int r0 = grid.row_of(min(y0, y1));
+			int r1 = grid.row_of(max(y0, y1));
+			for (int r = r0; r <= r1; ++r) visit(r * grid.cols + c);
+		}
+	};
+	int num_edges = static_cast<int>(edge_from.size());
+	grid.edge_offset.assign(num_cells + 1, 0);
+	for (int e = 0; e < num_edges; ++e) {
+		if (edge_to[e] == -1 || !indexed[edge_from[e]] || !indexed[edge_to[e]]) continue;
+		for_each_cell(e, [&](int c) { grid.edge_offset[c + 1]++; });
+	}
+	for (int c = 0; c < num_cells; ++c) {
+		grid.edge_offset[c + 1] += grid.edge_offset[c];
+	}
+	grid.edge_items.resize(grid.edge_offset[num_cells]);
+	cursor.assign(grid.edge_offset.begin(), grid.edge_offset.end() - 1);
+	for (int e = 0; e < num_edges; ++e) {
+		if (edge_to[e] == -1 || !indexed[edge_from[e]] || !indexed[edge_to[e]]) continue;
+		for_each_cell(e, [&](int c) { grid.edge_items[cursor[c]++] = e; });
+	}
+
+	spatial = move(grid);
+	return spatial;
+}
+
+
+// 查询点坐标须为有限值（无穷远或 NaN 的点无法落入网格）
+static void check_finite_points(
+	const ArrayView& xs,
+	const ArrayView& ys,
+	py::ssize_t n)
+{
+	for (py::ssize_t q = 0; q < n; ++q) {
+		if (!std::isfinite(xs.get_double(q)) || !std::isfinite(ys.get_double(q))) {
+			throw runtime_error("'x' and 'y' must be finite (index " + to_string(q) + ")");
+		}
+	}
+}
+
+
+// 批量查询最近的 k 个节点：自查询点所在单元逐圈向外扫描，已有 k 个且未扫描区域不可能更近时停止
+py::dict GraphAlgorithms::nearest_nodes(
+	const py::array& x_,
+	const py::array& y_,
+	int k,
+	int num_thread)
+{
+	// 1.校验
+	ArrayView xs(x_, "x", true);
+	ArrayView ys(y_, "y", true);
+	py::ssize_t n = x_.size();
+	if (y_.size() != n) {
+		throw runtime_error("'x' and 'y' must have the same length");
+	}
+	if (k < 1) {
+		throw runtime_error("'k' must be a positive integer");
+	}
+	check_finite_points(xs, ys, n);
+	const SpatialGrid& grid = get_spatial();
+
+	py::array_t<int> nodes({ n, static_cast<py::ssize_t>(k) });
+	py::array_t<double> distances({ n, static_cast<py::ssize_t>(k) });
+	int* node_ptr = static_cast<int*>(nodes.request().ptr);
+	double* dist_ptr = static_cast<double*>(distances.request().ptr);
+
+	// 2.释放 GIL，按查询分段并行
+	{
+		py::gil_scoped_release release;
+
+		size_t num_parts = thread_parts(n, num_thread);
+		parallel_parts(n, num_parts, [&](size_t, size_t begin, size_t end) {
+			vector<pair<double, int>> heap; // 当前最近的 k 个（距离平方，节点），最大堆
+			for (size_t q = begin; q < end; ++q) {
+				double x = xs.get_double(q);
+				double y = ys.get_double(q);
+				heap.clear();
+
+				if (grid.cols > 0) {
+					int cx = grid.col_of(x);
+					int cy = grid.row_of(y);
+					int max_r = max(max(cx, grid.cols - 1 - cx), max(cy, grid.rows - 1 - cy));
+					for (int r = 0; r <= max_r; ++r) {
+						// 扫描第 r 圈：首末两行整行，中间各行只取两端
+						for (int row = max(0, cy - r); row <= min(grid.rows - 1, cy + r); ++row) {
+							int step = (r == 0 || row == cy - r || row == cy + r) ? 1 : 2 * r;
+							for (int col = cx - r; col <= cx + r; col += step) {
+								if (col < 0 || col >= grid.cols) continue;
+								int c = row * grid.cols + col;
+								for (int i = grid.node_offset[c]; i < grid.node_offset[c + 1]; ++i) {
+									int u = grid.node_items[i];
+									double dx = node_x[u] - x;
+									double dy = node_y[u] - y;
+									pair<double, int> item(dx * dx + dy * dy, u);
+									if (static_cast<int>(heap.size()) < k) {
+										heap.push_back(item);
+										push_heap(heap.begin(), heap.end());
+									}
+									else if (item < heap.front()) {
+										pop_heap(heap.begin(), heap.end());
+										heap.back() = item;
+										push_heap(heap.begin(), heap.end());
+									}
+								}
+							}
+						}
+
+						// 未扫描的单元到查询点的最小距离（已到网格边界的方向不计）
+						if (static_cast<int>(heap.size()) < k) continue;
+						double bound = numeric_limits<double>::infinity();
+						if (cx - r > 0) bound = min(bound, x - (grid.min_x + (cx - r) * grid.cell));
+						if (cx + r < grid.cols - 1) bound = min(bound, grid.min_x + (cx + r + 1) * grid.cell - x);
+						if (cy - r > 0) bound = min(bound, y - (grid.min_y + (cy - r) * grid.cell));
+						if (cy + r < grid.rows - 1) bound = min(bound, grid.min_y + (cy + r + 1) * grid.cell - y);
+						if (bound >= 0 && bound * bound >= heap.front().first) break;
+					}
+				}
+
+				// 3.按距离升序写出，不足 k 个时以 -1 与 inf 补齐
+				sort_heap(heap.begin(), heap.end());
+				for (int j = 0; j < k; ++j) {
+					bool found = j < static_cast<int>(heap.size());
+					node_ptr[q * k + j] = found ? node_ids[heap[j].second] : -1;
+					dist_ptr[q * k + j] = found ? sqrt(heap[j].first) : numeric_limits<double>::infinity();
+				}
+			}
+		});
+	}
+
+	py::dict result;
+	result["node"] = nodes;
+	result["distance"] = distances;
+	return result;
+}
+
+
+// 批量查询 radius 范围内的边：扫描查询窗口覆盖的单元，逐条计算点到线段的投影
+py::dict GraphAlgorithms::nearest_edges(
+	const py::array& x_,
+	const py::array& y_,
+	double radius,
+	int num_thread)
+{
+	// 1.校验
+	ArrayView xs(x_, "x", true);
+	ArrayView ys(y_, "y", true);
+	py::ssize_t n = x_.size();
+	if (y_.size() != n) {
+		throw runtime_error("'x' and 'y' must have the same length");
+	}
+	if (!(radius >= 0) || !std::isfinite(radius)) {
+		throw runtime_error("'radius' must be a finite non-negative number");
+	}
+	check_finite_points(xs, ys, n);
+	const SpatialGrid& grid = get_spatial();
+
+	struct EdgeMatch {
+		int query; // 查询序号
+		int edge; // 边号
+		double x; // 投影点
+		double y;
+		double distance; // 查询点到投影点的距离
+		double offset; // 投影点沿边距起点的长度
+		double length; // 边（线段）长度
+	};
+
+	// 2.释放 GIL，按查询分段并行，各段结果按查询顺序拼接
+	size_t num_parts = thread_parts(n, num_thread);
+	vector<vector<EdgeMatch>> parts(num_parts);
+	{
+		py::gil_scoped_release release;
+
+		parallel_parts(n, num_parts, [&](size_t part, size_t begin, size_t end) {
+			auto& matches = parts[part];
+			vector<int> seen(edge_from.size(), -1); // 边号 -> 最近一次登记它的查询（边可能跨多个单元）
+			for (size_t q = begin; q < end; ++q) {
+				double x = xs.get_double(q);
+				double y = ys.get_double(q);
+				if (grid.cols == 0) continue;
+
+				size_t first = matches.size();
+				int c0 = grid.col_of(x - radius);
+				int c1 = grid.col_of(x + radius);
+				int r0 = grid.row_of(y - radius);
+				int r1 = grid.row_of(y + radius);
+				for (int row = r0; row <= r1; ++row) {
+					for (int col = c0; col <= c1; ++col) {
+						int c = row * grid.cols + col;
+						for (int i = grid.edge_offset[c]; i < grid.edge_offset[c + 1]; ++i) {
+							int e = grid.edge_items[i];
+							if (seen[e] == static_cast<int>(q)) continue;
+							seen[e] = static_cast<int>(q);
+
+							// 点到线段的投影，参数 t 截断到 [0, 1]
+							double ax = node_x[edge_from[e]];
+							double ay = node_y[edge_from[e]];
+							double dx = node_x[edge_to[e]] - ax;
+							double dy = node_y[edge_to[e]] - ay;
+							double len2 = dx * dx + dy * dy;
+							double t = len2 > 0 ? ((x - ax) * dx + (y - ay) * dy) / len2 : 0.0;
+							t = min(1.0, max(0.0, t));
+							double px = ax + t * dx;
+							double py = ay + t * dy;
+							double distance = hypot(x - px, y - py);
+							if (distance > radius) continue;
+							double length = sqrt(len2);
+							matches.push_back({ static_cast<int>(q), e, px, py, distance, t * length, length });
+						}
+					}
+				}
+				sort(matches.begin() + first, matches.end(), [](const EdgeMatch& a, const EdgeMatch& b) {
+					return a.distance != b.distance ? a.distance < b.distance : a.edge < b.edge;
+				});
+			}
+		});
+	}
+
+	// 3.拼接为平铺数组
+	size_t total = 0;
+	for (const auto& matches : parts) total += matches.size();
+	py::array_t<int> query(total), start(total), end(total);
+	py::array_t<double> proj_x(total), proj_y(total), distance(total), offset(total), length(total);
+	int* query_ptr = static_cast<int*>(query.request().ptr);
+	int* start_ptr = static_cast<int*>(start.request().ptr);
+	int* end_ptr = static_cast<int*>(end.request().ptr);
+	double* x_ptr = static_cast<double*>(proj_x.request().ptr);
+	double* y_ptr = static_cast<double*>(proj_y.request().ptr);
+	double* distance_ptr = static_cast<double*>(distance.request().ptr);
+	double* offset_ptr = static_cast<double*>(offset.request().ptr);
+	double* length_ptr = static_cast<double*>(length.request().ptr);
+	size_t i = 0;
+	for (const auto& matches : parts) {
+		for (const auto& m : matches) {
+			query_ptr[i] = m.query;
+			start_ptr[i] = node_ids[edge_from[m.edge]];
+			end_ptr[i] = node_ids[edge_to[m.edge]];
+			x_ptr[i] = m.x;
+			y_ptr[i] = m.y;
+			distance_ptr[i] = m.distance;
+			offset_ptr[i] = m.offset;
+			length_ptr[i] = m.length;
+			i++;
+		}
+	}
+
+	py::dict result;
+	result["query"] = query;
+	result["start"] = start;
+	result["end"] = end;
+	result["x"] = proj_x;
+	result["y"] = proj_y;
+	result["distance"] = distance;
+	result["offset"] = offset;
+	result["length"] = length;
+	return result;
+}
+
+
+// 路标索引 ---------------------------------------------------------------------------------------
+// 从 sources 出发的完整搜索（reverse 为真时沿入边），dist 为各节点花费（不可达为 inf），pred 非空时记录前驱
+static void full_search(
+	const CSRGraph& g,
+	int weight_index,
 	const vector<int>& sources,
-	int& target,
-	double& cut_off,
-	string& weight_name)
+	bool reverse,
+	vector<cost_t>& dist,
+	vector<int>* pred)
+{
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	ws.reset(g.num_nodes);
+	MinHeap pq(ws);
+	for (int s : sources) {
+		ws.set(s, 0.0, -1);
+		pq.emplace(0.0, s);
+	}
+
+	while (!pq.empty()) {
+		auto top = pq.top();
+		int u = top.second;
+		pq.pop();
+		if (top.first > ws.dist[u]) continue;
+
+		auto relax = [&](int v, weight_t w) {
+			const cost_t new_dist = top.first + w;
+			if (new_dist < ws.get(v)) {
+				ws.set(v, new_dist, u);
+				pq.emplace(new_dist, v);
+			}
+		};
+		if (reverse) g.for_each_in(u, weight_index, relax);
+		else g.for_each_out(u, weight_index, relax);
+	}
+
+	dist.assign(g.num_nodes, numeric_limits<cost_t>::infinity());
+	if (pred != nullptr) pred->assign(g.num_nodes, -1);
+	for (int v = 0; v < g.num_nodes; ++v) {
+		if (!ws.reached(v)) continue;
+		dist[v] = ws.dist[v];
+		if (pred != nullptr) (*pred)[v] = ws.pred[v];
+	}
+}
+
+
+// 为权重字段构建 ALT 路标索引
+void GraphAlgorithms::build_landmarks(
+	const string& weight_name,
+	int num_landmarks,
+	const string& selection,
+	int num_thread)
+{
+	if (num_landmarks < 1) {
+		throw runtime_error("num_landmarks must be a positive integer");
+	}
+	if (selection != "farthest" && selection != "avoid") {
+		throw runtime_error("unsupported landmark selection '" + selection + "', use 'farthest' or 'avoid'");
+	}
+
+	LandmarkIndex index;
+	index.num_landmarks = num_landmarks;
+	index.selection = selection;
+	index.num_thread = max(1, num_thread);
+	int weight_index = get_weight_index(weight_name);
+	{
+		py::gil_scoped_release release;
+		compute_landmarks(index, weight_index);
+	}
+	alt_index[weight_name] = move(index);
+}
+
+
+// 获取权重字段的路标索引
+const LandmarkIndex& GraphAlgorithms::get_landmarks(
+	const string& weight_name)
+{
+	auto it = alt_index.find(weight_name);
+	if (it == alt_index.end()) {
+		throw runtime_error("landmarks for weight '" + weight_name + "' are not built, call build_landmarks first");
+	}
+	LandmarkIndex& index = it->second;
+	int weight_index = get_weight_index(weight_name);
+	if (index.graph_version != graph_version || index.weight_version != weight_version) {
+		compute_landmarks(index, weight_index);
+	}
+	return index;
+}
+
+
+// 选择路标并计算正反向花费
+void GraphAlgorithms::compute_landmarks(
+	LandmarkIndex& index,
+	int weight_index)
+{
+	const CSRGraph& g = get_csr();
+	const int n = g.num_nodes;
+	const cost_t inf = numeric_limits<cost_t>::infinity();
+
+	// 1.候选节点：非形心点且至少有一条边
+	vector<int> candidates;
+	vector<char> is_candidate(n, 0);
+	for (int u = 0; u < n; ++u) {
+		if (is_centroid(u)) continue;
+		bool linked = false;
+		g.for_each_out(u, weight_index, [&](int, weight_t) { linked = true; });
+		if (!linked) g.for_each_in(u, weight_index, [&](int, weight_t) { linked = true; });
+		if (!linked) continue;
+		is_candidate[u] = 1;
+		candidates.push_back(u);
+	}
+	const int k = min(index.num_landmarks, static_cast<int>(candidates.size()));
+
+	// 各路标的正反向花费列，新路标的 2 次搜索分给各线程
+	vector<int> landmarks;
+	vector<vector<cost_t>> from_cols;
+	vector<vector<cost_t>> to_cols;
+	auto add_landmarks = [&](const vector<int>& added) {
+		size_t first = landmarks.size();
+		landmarks.insert(landmarks.end(), added.begin(), added.end());
+		from_cols.resize(landmarks.size());
+		to_cols.resize(landmarks.size());
+		size_t num_searches = 2 * added.size();
+		parallel_parts(num_searches, thread_parts(num_searches, index.num_thread), [&](size_t, size_t begin, size_t end) {
+			for (size_t j = begin; j < end; ++j) {
+				size_t i = first + j / 2;
+				bool reverse = j % 2 == 1;
+				full_search(g, weight_index, { landmarks[i] }, reverse, reverse ? to_cols[i] : from_cols[i], nullptr);
+			}
+		});
+	};
+
+	// 距当前路标集最远的候选节点（到达不了的优先），全部为路标时返回 -1
+	auto farthest_from = [&](const vector<int>& sources) {
+		vector<cost_t> dist;
+		full_search(g, weight_index, sources, false, dist, nullptr);
+		int best = -1;
+		for (int u : candidates) {
+			if (dist[u] == 0) continue;
+			if (best == -1 || dist[u] > dist[best]) best = u;
+		}
+		return best;
+	};
+
+	mt19937 rng(static_cast<unsigned>(index.num_landmarks));
+	if (index.selection == "farthest") {
+		// 2.farthest：从随机节点出发取最远点，此后每次取距已选路标集最远的节点
+		vector<int> selected;
+		if (k > 0) {
+			int first = farthest_from({ candidates[rng() % candidates.size()] });
+			if (first != -1) selected.push_back(first);
+		}
+		while (static_cast<int>(selected.size()) < k) {
+			int next = farthest_from(selected);
+			if (next == -1) break;
+			selected.push_back(next);
+		}
+		add_landmarks(selected);
+	}
+	else {
+		// 3.avoid：以随机根的最短路树上「实际花费 - 当前下界」为权，子树不含路标的节点累计子树权重，
+		//   从累计值最大的节点沿累计值最大的子节点下行至叶节点，取为新路标（下界越差的区域越优先覆盖）
+		vector<cost_t> dist;
+		vector<int> pred;
+		vector<double> subtree(n);
+		vector<char> covered(n);
+		vector<int> child_offset(n + 1);
+		vector<int> children;
+		vector<int> order;
+		vector<char> is_landmark(n, 0);
+		while (static_cast<int>(landmarks.size()) < k) {
+			int root = candidates[rng() % candidates.size()];
+			full_search(g, weight_index, { root }, false, dist, &pred);
+
+			// 3.1 子节点表与自根向下的顺序
+			fill(child_offset.begin(), child_offset.end(), 0);
+			for (int v = 0; v < n; ++v) {
+				if (pred[v] != -1) child_offset[pred[v] + 1]++;
+			}
+			for (int v = 0; v < n; ++v) child_offset[v + 1] += child_offset[v];
+			children.assign(child_offset[n], 0);
+			vector<int> fill_pos(child_offset.begin(), child_offset.end() - 1);
+			for (int v = 0; v < n; ++v) {
+				if (pred[v] != -1) children[fill_pos[pred[v]]++] = v;
+			}
+			order.assign(1, root);
+			for (size_t i = 0; i < order.size(); ++i) {
+				int u = order[i];
+				for (int c = child_offset[u]; c < child_offset[u + 1]; ++c) order.push_back(children[c]);
+			}
+
+			// 3.2 自底向上累计子树权重，含路标的子树记为 0
+			for (size_t i = order.size(); i-- > 0;) {
+				int u = order[i];
+				covered[u] = is_landmark[u];
+				// 当前下界 lb(root, u)
+				double bound = 0.0;
+				for (size_t j = 0; j < landmarks.size(); ++j) {
+					const cost_t* f = from_cols[j].data();
+					const cost_t* t = to_cols[j].data();
+					if (t[root] < inf && t[u] < inf) bound = max(bound, static_cast<double>(t[root]) - t[u]);
+					if (f[root] < inf && f[u] < inf) bound = max(bound, static_cast<double>(f[u]) - f[root]);
+				}
+				double sum = dist[u] - bound;
+				for (int c = child_offset[u]; c < child_offset[u + 1]; ++c) {
+					int v = children[c];
+					covered[u] |= covered[v];
+					sum += subtree[v];
+				}
+				subtree[u] = covered[u] ? 0.0 : sum;
+			}
+
+			// 3.3 取累计值最大的节点，沿累计值最大的子节点下行至叶节点
+			int node = -1;
+			for (int u : order) {
+				if (subtree[u] > 0 && (node == -1 || subtree[u] > subtree[node])) node = u;
+			}
+			if (node == -1) {
+				// 树已被路标覆盖：改取距路标集最远的节点
+				node = farthest_from(landmarks);
+				if (node == -1) break;
+			}
+			else {
+				while (true) {
+					int next = -1;
+					for (int c = child_offset[node]; c < child_offset[node + 1]; ++c) {
+						int v = children[c];
+						if (subtree[v] > 0 && (next == -1 || subtree[v] > subtree[next])) next = v;
+					}
+					if (next == -1) break;
+					node = next;
+				}
+			}
+			if (!is_candidate[node] || is_landmark[node]) break;
+			is_landmark[node] = 1;
+			add_landmarks({ node });
+		}
+	}
+
+	// 4.按节点连续存放
+	const int num = static_cast<int>(landmarks.size());
+	index.landmarks = landmarks;
+	index.from.assign(static_cast<size_t>(n) * num, inf);
+	index.to.assign(static_cast<size_t>(n) * num, inf);
+	for (int i = 0; i < num; ++i) {
+		for (int v = 0; v < n; ++v) {
+			index.from[static_cast<size_t>(v) * num + i] = from_cols[i][v];
+			index.to[static_cast<size_t>(v) * num + i] = to_cols[i][v];
+		}
+	}
+	index.graph_version = graph_version;
+	index.weight_version = weight_version;
+}
+
+
+// 收缩层次 ---------------------------------------------------------------------------------------
+// 为权重字段构建收缩层次
+void GraphAlgorithms::build_ch(
+	const string& weight_name)
 {
-	unordered_map<int, double> dist;
-	priority_queue<pair<double, int>, vector<pair<double, int>>, greater<>> pq;
+	ContractionHierarchy ch;
+	int weight_index = get_weight_index(weight_name);
+	{
+		py::gil_scoped_release release;
+		compute_ch(ch, weight_index);
+	}
+	ch_index[weight_name] = move(ch);
+}
 
-	// 初始化源节点
-	for (const auto& s : sources) {
-		dist[s] = 0.0;
-		pq.emplace(0.0, s);
+
+// 获取权重字段的收缩层次
+const ContractionHierarchy& GraphAlgorithms::get_ch(
+	const string& weight_name)
+{
+	auto it = ch_index.find(weight_name);
+	if (it == ch_index.end()) {
+		throw runtime_error("contraction hierarchy for weight '" + weight_name + "' is not built, call build_ch first");
+	}
+	ContractionHierarchy& ch = it->second;
+	int weight_index = get_weight_index(weight_name);
+	if (ch.graph_version != graph_version || ch.weight_version != weight_version) {
+		compute_ch(ch, weight_index);
+	}
+	return ch;
+}
+
+
+// 按快照权重列收缩全部节点：优先级为 2 × 新增捷径数 - 删除弧数 + 已收缩邻点数 + 层级，
+// 邻点收缩后只更新计数，弹出时重算优先级（惰性更新），变大则放回
+void GraphAlgorithms::compute_ch(
+	ContractionHierarchy& ch,
+	int weight_index)
+{
+	const CSRGraph& g = get_csr();
+	const int n = g.num_nodes;
+	const int max_settled = 500; // 见证搜索确定的节点数上限（超出时按需补充捷径，不影响正确性）
+
+	// 1.剩余图：每对节点至多一条弧（取最小权重），去掉自环
+	struct Arc {
+		int node; // 另一端
+		cost_t weight;
+		int middle; // 捷径的中间节点，原始边为 -1
+	};
+	vector<vector<Arc>> out(n);
+	vector<vector<Arc>> in(n);
+	auto add_arc = [&](int u, int v, cost_t w, int m) {
+		for (auto& a : out[u]) {
+			if (a.node != v) continue;
+			if (w < a.weight) {
+				a.weight = w;
+				a.middle = m;
+				for (auto& b : in[v]) {
+					if (b.node == u) {
+						b.weight = w;
+						b.middle = m;
+						break;
+					}
+				}
+			}
+			return false;
+		}
+		out[u].push_back({ v, w, m });
+		in[v].push_back({ u, w, m });
+		return true;
+	};
+	for (int u = 0; u < n; ++u) {
+		g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+			if (v != u) add_arc(u, v, w, -1);
+		});
+	}
+
+	// 2.见证搜索：剩余图上从 u 出发、绕开 v，v 的出邻点全部确定或超过 limit 时停止
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	vector<int> targets;
+	auto witness_search = [&](int u, int v, cost_t limit) {
+		ws.reset(n);
+		targets.clear();
+		for (const auto& b : out[v]) targets.push_back(b.node);
+		int remaining = ws.mark_targets(targets);
+		MinHeap pq(ws);
+		ws.set(u, 0.0, -1);
+		pq.emplace(0.0, u);
+		int settled = 0;
+		while (!pq.empty()) {
+			auto top = pq.top();
+			pq.pop();
+			int x = top.second;
+			if (top.first > ws.dist[x]) continue;
+			if (top.first > limit || ++settled > max_settled) break;
+			if (ws.settle_target(x) && --remaining == 0) break;
+			for (const auto& a : out[x]) {
+				if (a.node == v) continue;
+				const cost_t new_dist = top.first + a.weight;
+				if (new_dist < ws.get(a.node)) {
+					ws.set(a.node, new_dist, x);
+					pq.emplace(new_dist, a.node);
+				}
+			}
+		}
+	};
+
+	// 收缩 v 所需的捷径（apply 为真时加入剩余图），返回捷径数
+	auto contract = [&](int v, bool apply) {
+		int count = 0;
+		cost_t max_out = 0.0;
+		for (const auto& b : out[v]) max_out = max(max_out, b.weight);
+		for (const auto& a : in[v]) {
+			int u = a.node;
+			witness_search(u, v, a.weight + max_out);
+			for (const auto& b : out[v]) {
+				int x = b.node;
+				if (x == u) continue;
+				const cost_t via = a.weight + b.weight;
+				if (ws.get(x) <= via) continue;
+				++count;
+				if (apply) add_arc(u, x, via, v);
+			}
+		}
+		return count;
+	};
+
+	vector<int> removed_neighbors(n, 0); // 已收缩的邻点数
+	vector<int> level(n, 0); // 已收缩邻点的最大层级 + 1
+	auto priority = [&](int v) {
+		int removed = static_cast<int>(in[v].size() + out[v].size());
+		return 2 * contract(v, false) - removed + removed_neighbors[v] + level[v];
+	};
+
+	// 3.按优先级依次收缩，弹出时重算优先级，变大则放回
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> pq;
+	for (int v = 0; v < n; ++v) {
+		pq.emplace(priority(v), v);
 	}
 
+	ch.rank.assign(n, -1);
+	ch.order.clear();
+	ch.order.reserve(n);
+	ch.num_shortcuts = 0;
+	vector<vector<Arc>> up(n);
+	vector<vector<Arc>> down(n);
 	while (!pq.empty()) {
-		auto current = pq.top();
-		double& d = current.first; // 获取弹出 距离
-		int& u = current.second; // 获取弹出 节点
+		auto top = pq.top();
 		pq.pop();
+		int v = top.second;
+		int p = priority(v);
+		if (!pq.empty() && p > pq.top().first) {
+			pq.emplace(p, v);
+			continue;
+		}
 
-		if (d > dist[u]) continue; // 检查当前距离是否过时
+		// 收缩 v：记录其当前的出入弧（另一端均未收缩，rank 更高），再从剩余图中移除
+		int added = contract(v, true);
+		ch.num_shortcuts += added;
+		ch.rank[v] = static_cast<int>(ch.order.size());
+		ch.order.push_back(v);
+		up[v] = move(out[v]);
+		down[v] = move(in[v]);
+		vector<Arc>().swap(out[v]);
+		vector<Arc>().swap(in[v]);
+		for (const auto& a : up[v]) {
+			auto& list = in[a.node];
+			list.erase(remove_if(list.begin(), list.end(), [&](const Arc& b) { return b.node == v; }), list.end());
+		}
+		for (const auto& a : down[v]) {
+			auto& list = out[a.node];
+			list.erase(remove_if(list.begin(), list.end(), [&](const Arc& b) { return b.node == v; }), list.end());
+		}
 
-		if (u == target) break; // 当距离超过或等于cut_off时，移除该节点并不再处理
+		// 邻点计数更新（优先级在弹出时重算）
+		vector<int> neighbors;
+		for (const auto& a : up[v]) neighbors.push_back(a.node);
+		for (const auto& a : down[v]) neighbors.push_back(a.node);
+		sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+		for (int x : neighbors) {
+			removed_neighbors[x]++;
+			level[x] = max(level[x], level[v] + 1);
+		}
+	}
 
-		if (d > cut_off) { // 当距离超过cut_off时，移除该节点并不再处理
-			dist.erase(u);
-			continue;
+	// 4.向上弧与向下弧按另一端排序后平铺
+	auto flatten = [&](vector<vector<Arc>>& lists, vector<int>& offset, vector<int>& node, vector<cost_t>& weight, vector<int>& middle) {
+		offset.assign(n + 1, 0);
+		for (int v = 0; v < n; ++v) offset[v + 1] = offset[v] + static_cast<int>(lists[v].size());
+		node.resize(offset[n]);
+		weight.resize(offset[n]);
+		middle.resize(offset[n]);
+		for (int v = 0; v < n; ++v) {
+			auto& list = lists[v];
+			sort(list.begin(), list.end(), [](const Arc& a, const Arc& b) { return a.node < b.node; });
+			for (size_t i = 0; i < list.size(); ++i) {
+				node[offset[v] + i] = list[i].node;
+				weight[offset[v] + i] = list[i].weight;
+				middle[offset[v] + i] = list[i].middle;
+			}
+			vector<Arc>().swap(list);
 		}
+	};
+	flatten(up, ch.up_offset, ch.up_target, ch.up_weight, ch.up_middle);
+	flatten(down, ch.down_offset, ch.down_source, ch.down_weight, ch.down_middle);
+
+	// 5.向下弧按收缩次序重排，PHAST 扫描时顺序访问
+	ch.sweep_offset.assign(n + 1, 0);
+	for (int r = 0; r < n; ++r) {
+		int v = ch.order[r];
+		ch.sweep_offset[r + 1] = ch.sweep_offset[r] + ch.down_offset[v + 1] - ch.down_offset[v];
+	}
+	ch.sweep_source.resize(ch.sweep_offset[n]);
+	ch.sweep_weight.resize(ch.sweep_offset[n]);
+	for (int r = 0; r < n; ++r) {
+		int v = ch.order[r];
+		int q = ch.sweep_offset[r];
+		for (int p = ch.down_offset[v]; p < ch.down_offset[v + 1]; ++p, ++q) {
+			ch.sweep_source[q] = ch.rank[ch.down_source[p]];
+			ch.sweep_weight[q] = ch.down_weight[p];
+		}
+	}
+	ch.graph_version = graph_version;
+	ch.weight_version = weight_version;
+}
 
-		// 检查节点是否存在邻接表
-		auto u_it = g.find(u);
-		if (u_it == g.end()) continue;
 
-		auto& neighbors = u_it->second;
-		for (auto& edge : neighbors) {
-			int v = edge.first;
-			double weight = edge.second;
+// 多层覆盖图 -------------------------------------------------------------------------------------
+// 构建多层分区覆盖图
+void GraphAlgorithms::build_overlay(
+	int cell_size,
+	int num_levels,
+	int fanout)
+{
+	if (cell_size < 2 || num_levels < 1 || fanout < 2) {
+		throw runtime_error("build_overlay requires cell_size >= 2, num_levels >= 1 and fanout >= 2");
+	}
+	MultilevelOverlay ov;
+	ov.cell_size = cell_size;
+	ov.num_levels = num_levels;
+	ov.fanout = fanout;
+	get_csr();
+	{
+		py::gil_scoped_release release;
+		compute_overlay(ov);
+	}
+	overlay = move(ov);
+	// 已定制的权重字段在下次查询时按新分区重新定制
+	for (auto& item : overlay_metric) {
+		item.second.graph_version = -1;
+	}
+}
 
-			double new_dist = d + weight;
-			if (!dist.count(v) || new_dist < dist[v]) {
-				dist[v] = new_dist;
+
+// 定制团花费
+void GraphAlgorithms::customize_overlay(
+	const string& weight_name,
+	int num_thread)
+{
+	const MultilevelOverlay& ov = get_overlay();
+	OverlayMetric metric;
+	metric.num_thread = max(1, num_thread);
+	int weight_index = get_weight_index(weight_name);
+	{
+		py::gil_scoped_release release;
+		compute_overlay_metric(ov, metric, weight_index);
+	}
+	overlay_metric[weight_name] = move(metric);
+}
+
+
+// 获取覆盖图
+const MultilevelOverlay& GraphAlgorithms::get_overlay()
+{
+	if (overlay.graph_version == -1) {
+		throw runtime_error("overlay is not built, call build_overlay first");
+	}
+	if (overlay.graph_version != graph_version) {
+		get_csr();
+		compute_overlay(overlay);
+	}
+	return overlay;
+}
+
+
+// 获取权重字段的团花费
+const OverlayMetric& GraphAlgorithms::get_overlay_metric(
+	const string& weight_name)
+{
+	const MultilevelOverlay& ov = get_overlay();
+	auto it = overlay_metric.find(weight_name);
+	if (it == overlay_metric.end()) {
+		throw runtime_error("overlay metric for weight '" + weight_name + "' is not customized, call customize_overlay first");
+	}
+	OverlayMetric& metric = it->second;
+	int weight_index = get_weight_index(weight_name);
+	if (metric.graph_version != graph_version || metric.weight_version != weight_version) {
+		compute_overlay_metric(ov, metric, weight_index);
+	}
+	return metric;
+}
+
+
+// 逐层区域生长：第 l 层以第 l-1 层单元为单位（第 1 层以节点为单位），从编号最小的未分配单位出发
+// 贪心吸收连边最多的相邻单位，节点数不超过 cell_size × fanout^(l-1)；单元数不再减少或只剩一个时停止加层
+void GraphAlgorithms::compute_overlay(
+	MultilevelOverlay& ov)
+{
+	const CSRGraph& g = csr;
+	const int n = g.num_nodes;
+	ov.levels.clear();
+
+	// 1.快照中的有向边（不含形心边）
+	vector<pair<int, int>> arcs;
+	for (int u = 0; u < n; ++u) {
+		g.for_each_out_node(u, [&](int v) {
+			if (v != u) arcs.emplace_back(u, v);
+		});
+	}
+
+	vector<int> unit(n);
+	for (int u = 0; u < n; ++u) unit[u] = u;
+	vector<long long> unit_size(n, 1);
+	int num_units = n;
+	long long cap = ov.cell_size;
+	for (int l = 1; l <= ov.num_levels; ++l, cap *= ov.fanout) {
+		// 2.单位之间的无向邻接，权重为其间的边数
+		vector<pair<int, int>> links;
+		links.reserve(arcs.size() * 2);
+		for (const auto& arc : arcs) {
+			int x = unit[arc.first];
+			int y = unit[arc.second];
+			if (x == y) continue;
+			links.emplace_back(x, y);
+			links.emplace_back(y, x);
+		}
+		sort(links.begin(), links.end());
+		vector<int> offset(num_units + 1, 0);
+		vector<int> adj;
+		vector<int> adj_weight;
+		for (size_t i = 0; i < links.size(); ++i) {
+			if (i > 0 && links[i] == links[i - 1]) {
+				adj_weight.back()++;
+				continue;
+			}
+			offset[links[i].first + 1]++;
+			adj.push_back(links[i].second);
+			adj_weight.push_back(1);
+		}
+		vector<pair<int, int>>().swap(links);
+		for (int x = 0; x < num_units; ++x) offset[x + 1] += offset[x];
+
+		// 3.区域生长：每次吸收与当前单元连边最多的相邻单位，使单元紧凑、边界节点少
+		vector<int> group(num_units, -1);
+		vector<long long> group_size;
+		vector<int> conn(num_units, 0); // 与当前单元的连边数
+		vector<int> conn_group(num_units, -1); // conn 所属单元
+		vector<int> found(num_units, 0); // 进入当前单元边界的次序，连边数相同时先到先吸收
+		priority_queue<tuple<int, int, int>> frontier; // (连边数, -次序, 单位)
+		for (int seed = 0; seed < num_units; ++seed) {
+			if (group[seed] != -1) continue;
+			int c = static_cast<int>(group_size.size());
+			long long size = 0;
+			int num_found = 0;
+			auto absorb = [&](int x) {
+				group[x] = c;
+				size += unit_size[x];
+				for (int i = offset[x]; i < offset[x + 1]; ++i) {
+					int y = adj[i];
+					if (group[y] != -1) continue;
+					if (conn_group[y] != c) {
+						conn_group[y] = c;
+						conn[y] = 0;
+						found[y] = num_found++;
+					}
+					conn[y] += adj_weight[i];
+					frontier.emplace(conn[y], -found[y], y);
+				}
+			};
+			absorb(seed);
+			while (!frontier.empty() && size < cap) {
+				auto top = frontier.top();
+				frontier.pop();
+				int y = get<2>(top);
+				if (group[y] != -1 || get<0>(top) != conn[y] || size + unit_size[y] > cap) continue;
+				absorb(y);
+			}
+			frontier = priority_queue<tuple<int, int, int>>();
+			group_size.push_back(size);
+		}
+		int num_cells = static_cast<int>(group_size.size());
+		if (num_cells <= 1 || (l > 1 && num_cells == num_units)) break;
+
+		OverlayLevel level;
+		level.num_cells = num_cells;
+		level.cell.resize(n);
+		for (int u = 0; u < n; ++u) level.cell[u] = group[unit[u]];
+
+		// 4.入口与出口：跨单元边的终点与起点
+		vector<char> is_entry(n, 0), is_exit(n, 0);
+		for (const auto& arc : arcs) {
+			if (level.cell[arc.first] == level.cell[arc.second]) continue;
+			is_exit[arc.first] = 1;
+			is_entry[arc.second] = 1;
+		}
+		auto collect = [&](const vector<char>& flag, vector<int>& offset, vector<int>& nodes, vector<int>& pos) {
+			offset.assign(num_cells + 1, 0);
+			for (int u = 0; u < n; ++u) {
+				if (flag[u]) offset[level.cell[u] + 1]++;
+			}
+			for (int c = 0; c < num_cells; ++c) offset[c + 1] += offset[c];
+			nodes.resize(offset[num_cells]);
+			pos.assign(n, -1);
+			vector<int> fill(offset.begin(), offset.end() - 1);
+			for (int u = 0; u < n; ++u) {
+				if (!flag[u]) continue;
+				int c = level.cell[u];
+				pos[u] = fill[c] - offset[c];
+				nodes[fill[c]++] = u;
+			}
+		};
+		collect(is_entry, level.entry_offset, level.entries, level.entry_pos);
+		collect(is_exit, level.exit_offset, level.exits, level.exit_pos);
+		level.clique_offset.assign(num_cells + 1, 0);
+		for (int c = 0; c < num_cells; ++c) {
+			size_t num_entries = level.entry_offset[c + 1] - level.entry_offset[c];
+			size_t num_exits = level.exit_offset[c + 1] - level.exit_offset[c];
+			level.clique_offset[c + 1] = level.clique_offset[c] + num_entries * num_exits;
+		}
+
+		unit = level.cell;
+		unit_size = move(group_size);
+		num_units = num_cells;
+		ov.levels.push_back(move(level));
+	}
+	ov.graph_version = graph_version;
+}
+
+
+// 第 level 层覆盖图上 u 的出弧，visit(终点, 权重)：第 0 层为原图出边；
+// 第 l 层为所属单元内 u 到各出口的团弧（u 为入口时），以及离开单元的原图出边（u 为出口时）
+template <typename Visit>
+static void overlay_arcs(
+	const CSRGraph& g,
+	int weight_index,
+	const MultilevelOverlay& ov,
+	const OverlayMetric& metric,
+	int level,
+	int u,
+	Visit&& visit)
+{
+	if (level == 0) {
+		g.for_each_out(u, weight_index, visit);
+		return;
+	}
+	const OverlayLevel& lv = ov.levels[level - 1];
+	const int c = lv.cell[u];
+	const int row = lv.entry_pos[u];
+	if (row != -1) {
+		const int num_exits = lv.exit_offset[c + 1] - lv.exit_offset[c];
+		const cost_t* weights = metric.clique[level - 1].data() + lv.clique_offset[c] + static_cast<size_t>(row) * num_exits;
+		for (int j = 0; j < num_exits; ++j) {
+			int x = lv.exits[lv.exit_offset[c] + j];
+			if (x != u && weights[j] < numeric_limits<cost_t>::infinity()) visit(x, weights[j]);
+		}
+	}
+	if (lv.exit_pos[u] != -1) {
+		g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+			if (lv.cell[v] != c) visit(v, w);
+		});
+	}
+}
+
+
+// 第 level 层单元 c 内从 source 出发的搜索（使用第 level-1 层覆盖图的弧，只经单元内节点），
+// targets 全部确定后停止
+static void cell_search(
+	const CSRGraph& g,
+	int weight_index,
+	const MultilevelOverlay& ov,
+	const OverlayMetric& metric,
+	int level,
+	int c,
+	int source,
+	const vector<int>& targets,
+	SearchWorkspace& ws)
+{
+	const vector<int>& cell = ov.levels[level - 1].cell;
+	ws.reset(g.num_nodes);
+	int remaining = ws.mark_targets(targets);
+	MinHeap pq(ws);
+	ws.set(source, 0.0, -1);
+	pq.emplace(0.0, source);
+	while (!pq.empty()) {
+		auto top = pq.top();
+		int u = top.second;
+		pq.pop();
+		if (top.first > ws.dist[u]) continue;
+		if (ws.settle_target(u) && --remaining == 0) break;
+		overlay_arcs(g, weight_index, ov, metric, level - 1, u, [&](int v, cost_t w) {
+			if (cell[v] != c) return;
+			const cost_t new_dist = top.first + w;
+			if (new_dist < ws.get(v)) {
+				ws.set(v, new_dist, u);
+				pq.emplace(new_dist, v);
+			}
+		});
+	}
+}
+
+
+// 自底向上定制团花费
+void GraphAlgorithms::compute_overlay_metric(
+	const MultilevelOverlay& ov,
+	OverlayMetric& metric,
+	int weight_index)
+{
+	const CSRGraph& g = csr;
+	const int num_levels = static_cast<int>(ov.levels.size());
+	metric.clique.assign(num_levels, vector<cost_t>());
+	for (int l = 1; l <= num_levels; ++l) {
+		const OverlayLevel& lv = ov.levels[l - 1];
+		vector<cost_t>& clique = metric.clique[l - 1];
+		clique.assign(lv.clique_offset[lv.num_cells], numeric_limits<cost_t>::infinity());
+		size_t num_cells = lv.num_cells;
+		parallel_parts(num_cells, thread_parts(num_cells, metric.num_thread), [&](size_t, size_t begin, size_t end) {
+			SearchWorkspace& ws = SearchWorkspace::local(0);
+			for (size_t c = begin; c < end; ++c) {
+				const int exit_begin = lv.exit_offset[c];
+				const int num_exits = lv.exit_offset[c + 1] - exit_begin;
+				if (num_exits == 0) continue;
+				vector<int> exits(lv.exits.begin() + exit_begin, lv.exits.begin() + exit_begin + num_exits);
+				for (int i = lv.entry_offset[c]; i < lv.entry_offset[c + 1]; ++i) {
+					cell_search(g, weight_index, ov, metric, l, static_cast<int>(c), lv.entries[i], exits, ws);
+					cost_t* row = clique.data() + lv.clique_offset[c] + static_cast<size_t>(i - lv.entry_offset[c]) * num_exits;
+					for (int j = 0; j < num_exits; ++j) row[j] = ws.get(exits[j]);
+				}
+			}
+		});
+	}
+	metric.graph_version = graph_version;
+	metric.weight_version = weight_version;
+}
+
+
+// 覆盖图查询中各层含起点或目标的单元：节点所在单元均不含二者的最高层即其搜索层（0 为原图）
+struct OverlayLevels {
+	const MultilevelOverlay& ov;
+	vector<vector<char>> marked; // 层 -> 单元是否含起点或目标
+
+	OverlayLevels(
+		const MultilevelOverlay& ov_,
+		const vector<pair<int, cost_t>>& seeds,
+		const vector<int>& targets)
+		: ov(ov_), marked(ov_.levels.size()) {
+		for (size_t l = 0; l < ov.levels.size(); ++l) {
+			const OverlayLevel& lv = ov.levels[l];
+			marked[l].assign(lv.num_cells, 0);
+			for (const auto& seed : seeds) {
+				marked[l][lv.cell[seed.first]] = 1;
+			}
+			for (int t : targets) {
+				if (t != -1) marked[l][lv.cell[t]] = 1;
+			}
+		}
+	}
+
+	int level(int u) const {
+		for (int l = static_cast<int>(ov.levels.size()); l >= 1; --l) {
+			if (!marked[l - 1][ov.cell(l, u)]) return l;
+		}
+		return 0;
+	}
+};
+
+
+// 覆盖图上从 source 出发的搜索（工作区 ws），目标全部确定或超过 cut_off 后停止
+// seeds 为起始节点及初始花费，首项为 source 本身，其余项（形心点出边终点）的前驱记为 source
+static void overlay_search(
+	const CSRGraph& g,
+	int weight_index,
+	const MultilevelOverlay& ov,
+	const OverlayMetric& metric,
+	const OverlayLevels& levels,
+	const vector<pair<int, cost_t>>& seeds,
+	const vector<int>& targets,
+	double cut_off,
+	SearchWorkspace& ws)
+{
+	ws.reset(g.num_nodes);
+	int remaining = ws.mark_targets(targets);
+	MinHeap pq(ws);
+	const int source = seeds.front().first;
+	for (const auto& seed : seeds) {
+		if (seed.second < ws.get(seed.first)) {
+			ws.set(seed.first, seed.second, seed.first == source ? -1 : source);
+			pq.emplace(seed.second, seed.first);
+		}
+	}
+	while (!pq.empty()) {
+		auto top = pq.top();
+		int u = top.second;
+		pq.pop();
+		if (top.first > ws.dist[u]) continue;
+		if (top.first > cut_off) break;
+		if (ws.settle_target(u) && --remaining == 0) break;
+		overlay_arcs(g, weight_index, ov, metric, levels.level(u), u, [&](int v, cost_t w) {
+			const cost_t new_dist = top.first + w;
+			if (new_dist < ws.get(v)) {
+				ws.set(v, new_dist, u);
 				pq.emplace(new_dist, v);
 			}
+		});
+	}
+}
+
+
+// 将第 level 层团弧 u->v 展开为原图路径，依次追加 u 之后的各节点（不含 u）
+static void unpack_overlay_arc(
+	const CSRGraph& g,
+	int weight_index,
+	const MultilevelOverlay& ov,
+	const OverlayMetric& metric,
+	int level,
+	int u,
+	int v,
+	vector<int>& path)
+{
+	SearchWorkspace& ws = SearchWorkspace::local(1);
+	cell_search(g, weight_index, ov, metric, level, ov.cell(level, u), u, { v }, ws);
+	vector<int> hops;
+	for (int x = v; x != -1; x = ws.pred[x]) hops.push_back(x);
+	reverse(hops.begin(), hops.end());
+
+	// 单元内搜索只在子单元内部走团弧，跨子单元走原图边
+	for (size_t i = 1; i < hops.size(); ++i) {
+		if (level > 1 && ov.cell(level - 1, hops[i - 1]) == ov.cell(level - 1, hops[i])) {
+			unpack_overlay_arc(g, weight_index, ov, metric, level - 1, hops[i - 1], hops[i], path);
+		}
+		else {
+			path.push_back(hops[i]);
 		}
 	}
+}
 
-	return dist;
+
+// 图像文件 ---------------------------------------------------------------------------------------
+// 取图像中的一段为只读视图（长度、对齐或越界不符时抛出异常）
+template <typename T>
+static ArrayRef<T> image_section(
+	const shared_ptr<MappedRegion>& region,
+	const ImageSection* sections,
+	int64_t id,
+	int64_t count,
+	const string& path)
+{
+	const ImageSection& section = sections[id];
+	if (section.bytes != count * static_cast<int64_t>(sizeof(T)) ||
+		section.offset < 0 || section.offset % GRAPH_IMAGE_ALIGN != 0 ||
+		section.offset + section.bytes > static_cast<int64_t>(region->size())) {
+		throw runtime_error("invalid graph image '" + path + "': section " + to_string(id) + " is corrupt");
+	}
+	return ArrayRef<T>(region, reinterpret_cast<const T*>(region->data() + section.offset), static_cast<size_t>(count));
+}
+
+
+// 生成图像各段，交由 sink 写出（段数据仅在 sink 调用期间有效）
+void GraphAlgorithms::build_image(
+	const function<void(const ImageWriter&, const ImageHeader&)>& sink)
+{
+	thaw();
+	get_csr();
+	if (csr.has_delta() || (csr.edge_id.empty() && csr.num_edges > 0)) freeze(); // 合并增量层；映射加载的快照没有边号
+	const CSRGraph& g = csr;
+	int num_nodes = g.num_nodes;
+	int num_fields = static_cast<int>(edge_attr.field_names.size());
+
+	// 1.节点：按原始编号排序的查找表、形心标记
+	vector<int> sorted_index(num_nodes);
+	for (int u = 0; u < num_nodes; ++u) sorted_index[u] = u;
+	sort(sorted_index.begin(), sorted_index.end(), [&](int a, int b) { return node_ids[a] < node_ids[b]; });
+	vector<int> sorted_ids(num_nodes);
+	vector<uint8_t> centroid_flag(num_nodes);
+	for (int i = 0; i < num_nodes; ++i) {
+		sorted_ids[i] = node_ids[sorted_index[i]];
+		centroid_flag[i] = is_centroid(i) ? 1 : 0;
+	}
+
+	// 2.字段名、字段出现数
+	string field_names;
+	for (const auto& name : edge_attr.field_names) {
+		field_names += name;
+		field_names.push_back('\0');
+	}
+	vector<int64_t> field_count(edge_attr.count.begin(), edge_attr.count.end());
+
+	// 3.形心边（不在快照中），属性按字段展开，缺失为 NaN
+	vector<int> centroid_from, centroid_to, centroid_edge;
+	for (const auto& item : m_centroid_start_map) {
+		for (const auto& edge : item.second) {
+			centroid_from.push_back(item.first);
+			centroid_to.push_back(edge.first);
+			centroid_edge.push_back(edge.second);
+		}
+	}
+	for (const auto& item : m_centroid_end_map) {
+		for (const auto& edge : item.second) {
+			if (is_centroid(edge.first)) continue; // 已在起点容器中
+			centroid_from.push_back(edge.first);
+			centroid_to.push_back(item.first);
+			centroid_edge.push_back(edge.second);
+		}
+	}
+	size_t num_centroid_edges = centroid_edge.size();
+	vector<double> centroid_values(num_fields * num_centroid_edges);
+	for (int f = 0; f < num_fields; ++f) {
+		for (size_t i = 0; i < num_centroid_edges; ++i) {
+			centroid_values[f * num_centroid_edges + i] = edge_attr.get(f, centroid_edge[i], numeric_limits<double>::quiet_NaN());
+		}
+	}
+
+	// 4.快照边的存在位图（按 CSR 位置），并确保各字段权重列已构建
+	vector<vector<uint64_t>> out_present(num_fields);
+#ifdef GRAPHWORK_COMPACT
+	// 紧凑模式下快照权重列为 float，图像中的权重列按边号从属性表收集 double 值
+	vector<vector<double>> out_values(num_fields), in_values(num_fields);
+#endif
+	for (int f = 0; f < num_fields; ++f) {
+		if (edge_attr.count[f] == 0) continue;
+		get_weight_index(edge_attr.field_names[f]);
+#ifdef GRAPHWORK_COMPACT
+		out_values[f].resize(g.num_edges);
+		in_values[f].resize(g.num_edges);
+		for (int pos = 0; pos < g.num_edges; ++pos) {
+			out_values[f][pos] = get_edge_weight(g.edge_id[pos], f);
+		}
+		for (int pos = 0; pos < g.num_edges; ++pos) {
+			in_values[f][pos] = out_values[f][g.in_edge[pos]];
+		}
+#endif
+		out_present[f].assign((g.num_edges + 63) / 64, 0);
+		for (int pos = 0; pos < g.num_edges; ++pos) {
+			if (edge_attr.has(f, g.edge_id[pos])) {
+				out_present[f][pos >> 6] |= uint64_t(1) << (pos & 63);
+			}
+		}
+	}
+
+	// 5.按 ImageSectionId 顺序写出
+	ImageWriter writer;
+	writer.add(node_ids);
+	writer.add(sorted_ids);
+	writer.add(sorted_index);
+	writer.add(centroid_flag);
+	writer.add(g.out_offset);
+	writer.add(g.out_target);
+	writer.add(g.in_offset);
+	writer.add(g.in_source);
+	writer.add(field_names.data(), field_names.size());
+	writer.add(field_count);
+	writer.add(centroid_from);
+	writer.add(centroid_to);
+	writer.add(centroid_values);
+	for (int f = 0; f < num_fields; ++f) {
+		auto it = g.field_index.find(edge_attr.field_names[f]);
+		if (edge_attr.count[f] == 0 || it == g.field_index.end()) {
+			writer.add(nullptr, 0);
+			writer.add(nullptr, 0);
+			writer.add(nullptr, 0);
+			continue;
+		}
+#ifdef GRAPHWORK_COMPACT
+		writer.add(out_values[f]);
+		writer.add(in_values[f]);
+#else
+		writer.add(g.out_weight[it->second]);
+		writer.add(g.in_weight[it->second]);
+#endif
+		writer.add(out_present[f]);
+	}
+
+	ImageHeader header = {};
+	memcpy(header.magic, GRAPH_IMAGE_MAGIC, sizeof(header.magic));
+	header.version = GRAPH_IMAGE_VERSION;
+	header.byte_order = GRAPH_IMAGE_BYTE_ORDER;
+	header.num_nodes = num_nodes;
+	header.num_edges = g.num_edges;
+	header.num_centroid_edges = static_cast<int64_t>(num_centroid_edges);
+	header.num_fields = num_fields;
+	header.number_link = number_link;
+	sink(writer, header);
+}
+
+
+// 保存图像文件
+void GraphAlgorithms::save(
+	const string& path)
+{
+	build_image([&](const ImageWriter& writer, const ImageHeader& header) {
+		ofstream out(path, ios::binary | ios::trunc);
+		if (!out) {
+			throw runtime_error("cannot write graph image '" + path + "'");
+		}
+		writer.write(out, header);
+		if (!out) {
+			throw runtime_error("failed writing graph image '" + path + "'");
+		}
+	});
+}
+
+
+// 映射加载图像文件
+void GraphAlgorithms::load(
+	const string& path)
+{
+	load_region(MappedRegion::open_file(path), path);
+}
+
+
+// 发布到具名共享内存
+void GraphAlgorithms::publish_shared(
+	const string& name)
+{
+	build_image([&](const ImageWriter& writer, const ImageHeader& header) {
+		ImageHeader sized = header;
+		writer.layout(sized);
+		auto region = MappedRegion::create_shared(name, static_cast<size_t>(sized.file_size));
+		writer.write(region->mutable_data(), header);
+		published = region; // 保持映射（Windows 下具名映射随句柄释放）
+	});
+}
+
+
+// 挂接具名共享内存中的图
+void GraphAlgorithms::attach_shared(
+	const string& name)
+{
+	load_region(MappedRegion::open_shared(name), name);
+}
+
+
+// 删除具名共享内存
+void GraphAlgorithms::unlink_shared(
+	const string& name)
+{
+	MappedRegion::remove_shared(name);
+}
+
+
+// 加载映射区域中的图像：快照数组直接指向映射区域，哈希结构在首次修改时由 thaw 重建
+void GraphAlgorithms::load_region(
+	const shared_ptr<MappedRegion>& region,
+	const string& path)
+{
+	auto fail = [&path](const string& reason) {
+		throw runtime_error("invalid graph image '" + path + "': " + reason);
+	};
+
+	// 1.校验文件头与目录（数据区不逐项解析）
+	ImageHeader header;
+	if (region->size() < sizeof(header)) fail("truncated header");
+	memcpy(&header, region->data(), sizeof(header));
+	if (memcmp(header.magic, GRAPH_IMAGE_MAGIC, sizeof(header.magic)) != 0) fail("bad magic");
+	if (header.version != GRAPH_IMAGE_VERSION) fail("unsupported version " + to_string(header.version));
+	if (header.byte_order != GRAPH_IMAGE_BYTE_ORDER) fail("byte order mismatch");
+	if (header.file_size > static_cast<int64_t>(region->size())) fail("file size mismatch"); // 共享内存映射可能按页取整
+	if (header.num_nodes < 0 || header.num_edges < 0 || header.num_centroid_edges < 0 || header.num_fields < 0 ||
+		header.num_sections != IMAGE_FIXED_SECTIONS + header.num_fields * IMAGE_SECTIONS_PER_FIELD ||
+		static_cast<int64_t>(sizeof(header) + sizeof(ImageSection) * header.num_sections) > header.file_size) {
+		fail("bad section table");
+	}
+	const ImageSection* sections = reinterpret_cast<const ImageSection*>(region->data() + sizeof(header));
+	int64_t num_nodes = header.num_nodes;
+	int64_t num_edges = header.num_edges;
+	int64_t num_centroid = header.num_centroid_edges;
+	int64_t num_fields = header.num_fields;
+
+	auto node_view = image_section<int>(region, sections, IMAGE_NODE_IDS, num_nodes, path);
+	auto out_offset = image_section<int>(region, sections, IMAGE_OUT_OFFSET, num_nodes + 1, path);
+	auto in_offset = image_section<int>(region, sections, IMAGE_IN_OFFSET, num_nodes + 1, path);
+	if (num_nodes > INT32_MAX || num_edges > INT32_MAX) fail("graph too large");
+	if (out_offset[0] != 0 || out_offset[num_nodes] != num_edges || in_offset[0] != 0 || in_offset[num_nodes] != num_edges) {
+		fail("bad adjacency offsets");
+	}
+	for (int64_t u = 0; u < num_nodes; ++u) {
+		if (out_offset[u] > out_offset[u + 1] || in_offset[u] > in_offset[u + 1]) fail("bad adjacency offsets");
+	}
+
+	const ImageSection& names_section = sections[IMAGE_FIELD_NAMES];
+	if (names_section.offset < 0 || names_section.bytes < 0 || names_section.offset + names_section.bytes > header.file_size) {
+		fail("bad field names");
+	}
+	vector<string> field_names;
+	const char* name_ptr = region->data() + names_section.offset;
+	const char* name_end = name_ptr + names_section.bytes;
+	while (name_ptr < name_end) {
+		const char* stop = static_cast<const char*>(memchr(name_ptr, '\0', name_end - name_ptr));
+		if (stop == nullptr) fail("bad field names");
+		field_names.emplace_back(name_ptr, stop);
+		name_ptr = stop + 1;
+	}
+	if (static_cast<int64_t>(field_names.size()) != num_fields) fail("bad field names");
+
+	// 其余各段也先映射并校验，全部通过后才替换当前图（损坏的图像不破坏现有图）
+	auto sorted_ids = image_section<int>(region, sections, IMAGE_SORTED_IDS, num_nodes, path);
+	auto sorted_index = image_section<int>(region, sections, IMAGE_SORTED_INDEX, num_nodes, path);
+	auto centroid_flag = image_section<uint8_t>(region, sections, IMAGE_CENTROID_FLAG, num_nodes, path);
+	auto out_target = image_section<int>(region, sections, IMAGE_OUT_TARGET, num_edges, path);
+	auto in_source = image_section<int>(region, sections, IMAGE_IN_SOURCE, num_edges, path);
+	auto field_count = image_section<int64_t>(region, sections, IMAGE_FIELD_COUNT, num_fields, path);
+	auto centroid_from = image_section<int>(region, sections, IMAGE_CENTROID_FROM, num_centroid, path);
+	auto centroid_to = image_section<int>(region, sections, IMAGE_CENTROID_TO, num_centroid, path);
+	auto centroid_values = image_section<double>(region, sections, IMAGE_CENTROID_VALUES, num_fields * num_centroid, path);
+	for (int64_t i = 0; i < num_centroid; ++i) {
+		int o = centroid_from[i];
+		int d = centroid_to[i];
+		if (o < 0 || o >= num_nodes || d < 0 || d >= num_nodes) fail("bad centroid edge");
+	}
+
+	// 数组内容逐项线性校验：邻接终点、查找表越界或无序时，后续读取会越界
+	for (int64_t e = 0; e < num_edges; ++e) {
+		if (out_target[e] < 0 || out_target[e] >= num_nodes || in_source[e] < 0 || in_source[e] >= num_nodes) fail("bad adjacency targets");
+	}
+	for (int64_t i = 0; i < num_nodes; ++i) {
+		int u = sorted_index[i];
+		if (u < 0 || u >= num_nodes || node_view[u] != sorted_ids[i] || (i > 0 && sorted_ids[i - 1] >= sorted_ids[i])) fail("bad node lookup table");
+	}
+	vector<ArrayRef<double>> out_weight, in_weight;
+	vector<ArrayRef<uint64_t>> out_present;
+	for (int64_t f = 0; f < num_fields; ++f) {
+		int64_t base_id = IMAGE_FIXED_SECTIONS + f * IMAGE_SECTIONS_PER_FIELD;
+		bool has_column = sections[base_id + IMAGE_FIELD_OUT_WEIGHT].bytes != 0;
+		int64_t length = has_column ? num_edges : 0;
+		out_weight.push_back(image_section<double>(region, sections, base_id + IMAGE_FIELD_OUT_WEIGHT, length, path));
+		in_weight.push_back(image_section<double>(region, sections, base_id + IMAGE_FIELD_IN_WEIGHT, length, path));
+		out_present.push_back(image_section<uint64_t>(region, sections, base_id + IMAGE_FIELD_OUT_PRESENT, has_column ? (num_edges + 63) / 64 : 0, path));
+	}
+
+	// 2.重置图，装入节点编号与查找表（版本号延续递增，旧图上构建的派生索引不会被误认为有效）
+	long long next_graph_version = graph_version + 1;
+	long long next_weight_version = weight_version + 1;
+	long long next_layout_version = layout_version + 1;
+	long long next_coord_version = coord_version + 1;
+	static_cast<CGraph&>(*this) = CGraph();
+	graph_version = next_graph_version;
+	weight_version = next_weight_version;
+	layout_version = next_layout_version;
+	coord_version = next_coord_version;
+	if (compacting.valid()) compacting.wait();
+	compacting = future<CSRGraph>();
+	csr = CSRGraph();
+	published.reset();
+	bool chains_enabled = chains.enabled;
+	chains = ChainIndex(); // 派生索引随图一并作废
+	chains.enabled = chains_enabled;
+	alt_index.clear();
+	ch_index.clear();
+	overlay = MultilevelOverlay();
+	overlay_metric.clear();
+	spatial = SpatialGrid();
+	coord_check_graph = -1;
+	coord_check_coord = -1;
+	coords_complete = false;
+	node_ids.assign(node_view.begin(), node_view.end());
+	number_link = static_cast<int>(header.number_link);
+	image.sorted_ids = sorted_ids;
+	image.sorted_index = sorted_index;
+	image.centroid_flag = centroid_flag;
+	image.out_offset = out_offset;
+	image.out_target = out_target;
+	image.active = true;
+
+	// 3.字段列与出现数
+	for (int64_t f = 0; f < num_fields; ++f) {
+		intern_field(field_names[f]);
+		edge_attr.count[f] = static_cast<int>(field_count[f]);
+	}
+
+	// 4.形心边数量少，直接写入边表与形心容器
+	for (int64_t i = 0; i < num_centroid; ++i) {
+		int o = centroid_from[i];
+		int d = centroid_to[i];
+		int e = new_edge(o, d);
+		if (is_centroid(o)) m_centroid_start_map[o][d] = e;
+		if (is_centroid(d)) m_centroid_end_map[d][o] = e;
+		for (int64_t f = 0; f < num_fields; ++f) {
+			double value = centroid_values[f * num_centroid + i];
+			if (std::isnan(value)) continue;
+			edge_attr.values[f][e] = value;
+			edge_attr.present[f][e >> 6] |= uint64_t(1) << (e & 63);
+		}
+	}
+
+	// 5.快照直接指向映射区域
+	csr.num_nodes = static_cast<int>(num_nodes);
+	csr.num_base_nodes = csr.num_nodes;
+	csr.num_edges = static_cast<int>(num_edges);
+	csr.version = graph_version;
+	csr.layout_version = layout_version;
+	edge_log_enabled = true;
+	csr.out_offset = out_offset;
+	csr.out_target = out_target;
+	csr.in_offset = in_offset;
+	csr.in_source = in_source;
+	image.out_weight = move(out_weight);
+	image.in_weight = move(in_weight);
+	image.out_present = move(out_present);
+
+	// 6.常驻字段直接引用图像中的列，其余字段首次使用时引用
+	for (const auto& name : prepared_fields) {
+		get_weight_index(name);
+	}
+}
+
+
+// 结果转换（内部索引 -> 原始编号，仅在返回 Python 时调用）---------------------------------------
+// 花费结果转字典
+unordered_map<int, double> GraphAlgorithms::cost_to_map(
+	const SearchResult& result) const
+{
+	unordered_map<int, double> cost;
+	cost.reserve(result.touched.size());
+	for (int v : result.touched) {
+		cost[node_ids[v]] = result.dist(v);
+	}
+	return cost;
+}
+
+
+// 路径结果转字典
+unordered_map<int, vector<int>> GraphAlgorithms::path_to_map(
+	const SearchResult& result) const
+{
+	unordered_map<int, vector<int>> paths;
+	paths.reserve(result.touched.size());
+	for (int v : result.touched) {
+		paths[node_ids[v]] = path_to_external(result.path(v));
+	}
+	return paths;
+}
+
+
+// 路径花费结果转字典
+dis_and_path GraphAlgorithms::all_to_map(
+	const SearchResult& result) const
+{
+	return { cost_to_map(result), path_to_map(result) };
+}
+
+
+// 路径转原始编号
+vector<int> GraphAlgorithms::path_to_external(
+	const vector<int>& path) const
+{
+	vector<int> external;
+	external.reserve(path.size());
+	for (int u : path) {
+		external.push_back(node_ids[u]);
+	}
+	return external;
+}
+
+
+// 核心算法 ---------------------------------------------------------------------------------------
+// 当前线程的搜索工作区
+SearchWorkspace& SearchWorkspace::local(
+	int slot)
+{
+	thread_local SearchWorkspace workspaces[2];
+	return workspaces[slot];
+}
+
+
+// 解析方法名中的优先队列后缀
+QueueKind GraphAlgorithms::dijkstra_queue(
+	const string& method)
+{
+	if (method == "Dijkstra") return QueueKind::Binary;
+	if (method == "Dijkstra-4ary") return QueueKind::QuadHeap;
+	if (method == "Dijkstra-radix") return QueueKind::Radix;
+	if (method == "Dijkstra-dial") return QueueKind::Dial;
+	return QueueKind::None;
 }
 
 
-// 多源路径
-unordered_map<int, vector<int>> GraphAlgorithms::multi_source_dijkstra_path(
-	const unordered_map<int, vector<pair<int, double>>>& g,
+// 多源花费（源点、目标集均为内部索引）：目标集非空时，全部目标确定后即停止
+template <typename Queue>
+SearchResult GraphAlgorithms::dijkstra_search(
+	const CSRGraph& g,
+	int weight_index,
 	const vector<int>& sources,
-	int target,
-	double cut_off,
-	string weight_name)
+	const vector<int>& targets,
+	double cut_off)
 {
-	unordered_map<int, vector<int>> paths;
-	// 检查目标是否是源节点之一
-	for (const auto& s : sources) {
-		if (s == target) {
-			return { {s, {s}} };
-		}
-	}
-
-	// 初始化
-	unordered_map<int, double> dist;
-	unordered_map<int, int> pred;
-	priority_queue<
-		pair<double, int>,
-		vector<pair<double, int>>,
-		greater<>
-	> pq;
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	ws.reset(g.num_nodes);
+	SearchResult result;
+	result.workspace = &ws;
+	auto& touched = result.touched;
+	int remaining = ws.mark_targets(targets); // 尚未确定的目标数
+	Queue pq(ws);
 
 	// 初始化源节点
 	for (const auto& s : sources) {
-		dist[s] = 0.0;
+		if (!ws.reached(s)) touched.push_back(s);
+		ws.set(s, 0.0, -1);
 		pq.emplace(0.0, s);
-		pred[s] = -1;
-		paths[s] = { s };
 	}
 
-	// 遍历优先队列， 更新最短路径
 	while (!pq.empty()) {
-		pair<double, int> top = pq.top();
+		auto current = pq.top();
+		cost_t d = current.first; // 获取弹出 距离
+		int u = current.second; // 获取弹出 节点
 		pq.pop();
-		double d = top.first;  // 获取距离
-		int u = top.second;    // 获取节点
 
-		if (d > dist[u]) continue; // 跳过已处理的更优路径
+		if (d > ws.dist[u]) continue; // 检查当前距离是否过时
 
-		if (u == target) break; // 
+		if (remaining > 0 && ws.settle_target(u) && --remaining == 0) break; // 目标全部确定
 
-		if (d > cut_off) { // 当距离超过cut_off时，移除该节点并不再处理
-			dist.erase(u);
-			continue;
-		}
+		if (d > cut_off) break; // 之后弹出的距离均超过cut_off
 
-		// 检查节点是否存在邻接表
-		auto u_it = g.find(u);
-		if (u_it == g.end()) continue;
+		g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+			cost_t new_dist = d + w;
+			if (!ws.reached(v)) {
+				touched.push_back(v);
+			}
+			else if (new_dist >= ws.dist[v]) {
+				return;
+			}
+			ws.set(v, new_dist, u);
+			pq.emplace(new_dist, v);
+		});
+	}
 
-		// 遍历邻居并更新距离
-		auto& neighbors = u_it->second;
-		for (const auto& edge : neighbors) {
-			int v = edge.first;
-			double weight = edge.second;
+	// 剔除超过 cut_off 的节点
+	filter_cut_off(result, cut_off);
+	return result;
+}
 
-			double new_dist = d + weight;
-			// 发现更短路径
-			// 修改路径构建逻辑
-			if (!dist.count(v) || new_dist < dist[v]) {
-				dist[v] = new_dist;
-				pred[v] = u;
-				pq.emplace(new_dist, v);
 
-				// 重构路径生成逻辑
-				vector<int> new_path;
-				if (pred[v] != -1) {
-					new_path = paths[pred[v]];
-				}
-				new_path.push_back(v);
-				paths[v] = new_path;
-			}
-		}
-		
+SearchResult GraphAlgorithms::multi_source_dijkstra_cost(
+	const CSRGraph& g,
+	int weight_index,
+	const vector<int>& sources,
+	const vector<int>& targets,
+	double cut_off,
+	QueueKind queue)
+{
+	switch (queue) {
+	case QueueKind::QuadHeap:
+		return dijkstra_search<QuadHeap>(g, weight_index, sources, targets, cut_off);
+	case QueueKind::Radix:
+		return dijkstra_search<RadixHeap>(g, weight_index, sources, targets, cut_off);
+	case QueueKind::Dial:
+		return dijkstra_search<BucketQueue>(g, weight_index, sources, targets, cut_off);
+	default:
+		return dijkstra_search<MinHeap>(g, weight_index, sources, targets, cut_off);
 	}
+}
 
-	//返回序列路径
-	return paths;
-};
+
+SearchResult GraphAlgorithms::multi_source_dijkstra_cost(
+	const CSRGraph& g,
+	int weight_index,
+	const vector<int>& sources,
+	int target,
+	double cut_off,
+	QueueKind queue)
+{
+	return multi_source_dijkstra_cost(g, weight_index, sources, target == -1 ? vector<int>() : vector<int>{ target }, cut_off, queue);
+}
 
 
-// 多源路径花费
-dis_and_path GraphAlgorithms::multi_source_dijkstra(
-	const unordered_map<int, vector<pair<int, double>>>& g,
+// 多源路径花费（源点、目标点均为内部索引）：搜索只记录前驱，路径由 SearchResult::path 按需回溯
+SearchResult GraphAlgorithms::multi_source_dijkstra(
+	const CSRGraph& g,
+	int weight_index,
 	const vector<int>& sources,
 	int target,
 	double cut_off,
-	string weight_name)
+	QueueKind queue)
 {
 	// 检查目标是否是源节点之一
 	for (const auto& s : sources) {
 		if (s == target) {
-			return { {{s, 0}}, {{s, {s}}} };
-		}
-	}
-	unordered_map<int, vector<int>> paths;
-	// 初始化
-	unordered_map<int, double> dist;
-	unordered_map<int, int> pred;
-	priority_queue<
-		pair<double, int>,
-		vector<pair<double, int>>,
-		greater<>
-	> pq;
-
-	// 初始化源节点
-	for (const auto& s : sources) {
-		dist[s] = 0.0;
-		pq.emplace(0.0, s);
-		pred[s] = -1; // 表示源节点无前驱
-		paths[s] = { s };
-	}
-
-	// 遍历优先队列， 更新最短路径
-	while (!pq.empty()) {
-		pair<double, int> top = pq.top();
-		pq.pop();
-		double d = top.first;  // 获取距离
-		int u = top.second;    // 获取节点
-
-		// 跳过已处理的更优路径
-		if (d > dist[u]) continue;
-
-		if (u == target) break; // 
-
-		if (d > cut_off) { // 当距离超过cut_off时，移除该节点并不再处理
-			dist.erase(u);
-			continue;
-		}
-
-		// 检查节点是否存在邻接表
-		auto u_it = g.find(u);
-		if (u_it == g.end()) continue;
-
-		// 遍历邻居并更新距离
-		auto& neighbors = u_it->second;
-		for (const auto& edge : neighbors) {
-			int v = edge.first;
-			double weight = edge.second;
-
-			double new_dist = d + weight;
-			// 发现更短路径
-			if (!dist.count(v) || new_dist < dist[v]) {
-				dist[v] = new_dist;
-				pred[v] = u;
-				pq.emplace(new_dist, v);
-
-				// 重构路径生成逻辑
-				vector<int> new_path;
-				if (pred[v] != -1) {
-					new_path = paths[pred[v]];
-				}
-				new_path.push_back(v);
-				paths[v] = new_path;
-			}
+			SearchWorkspace& ws = SearchWorkspace::local(0);
+			ws.reset(g.num_nodes);
+			SearchResult result;
+			result.workspace = &ws;
+			ws.set(s, 0.0, -1);
+			result.touched.push_back(s);
+			return result;
 		}
 	}
 
-	//返回最短路径和花费
-	return { dist, paths };
+	return multi_source_dijkstra_cost(g, weight_index, sources, target, cut_off, queue);
 }
 
 
-// 多源路径花费形心点
-unordered_map<int, double> GraphAlgorithms::multi_source_dijkstra_cost_centroid(
+// 多源路径花费形心点（源点、目标集均为内部索引）：目标集非空时，全部目标确定后即停止
+template <typename Queue>
+SearchResult GraphAlgorithms::dijkstra_search_centroid(
+	const CSRGraph& g,
+	int weight_index,
 	const vector<int>& sources,
-	int target,
+	const vector<int>& targets,
 	double cut_off,
-	string weight_name)
-
+	const string& weight_name)
 {
-	unordered_map<int, double> dist;
-	priority_queue<pair<double, int>, vector<pair<double, int>>, greater<>> pq;
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	ws.reset(g.num_nodes);
+	SearchResult result;
+	result.workspace = &ws;
+	int field = edge_attr.find(weight_name); // 形心边权重直接读属性列
+	auto& touched = result.touched;
+	int remaining = ws.mark_targets(targets); // 尚未确定的目标数
+	Queue pq(ws);
+
+	// 松弛节点
+	auto relax = [&](int v, cost_t d, int u) {
+		if (!ws.reached(v)) {
+			touched.push_back(v);
+		}
+		else if (d >= ws.dist[v]) {
+			return;
+		}
+		ws.set(v, d, u);
+		pq.emplace(d, v);
+	};
 
-	// 初始化源节点
+	// 初始化源节点：形心点在快照中没有出边，直接从其出边开始
 	for (const auto& s : sources) {
-		dist[s] = 0.0;
-		pq.emplace(0.0, s);
+		if (!is_centroid(s)) {
+			relax(s, 0.0, -1);
+			continue;
+		}
+		if (!ws.reached(s)) touched.push_back(s);
+		ws.set(s, 0.0, -1);
+		auto start_it = m_centroid_start_map.find(s);
+		if (start_it == m_centroid_start_map.end()) continue;
+		for (const auto& edge : start_it->second) {
+			if (is_centroid(edge.first)) continue;
+			relax(edge.first, get_edge_weight(edge.second, field), s);
+		}
 	}
 
 	while (!pq.empty()) {
 		auto current = pq.top();
-		double d = current.first;
+		cost_t d = current.first;
 		int u = current.second;
 		pq.pop();
 
-		if (d > dist[u]) continue;
-		if (u == target) break;
-		if (d > cut_off) { // 当距离超过cut_off时，移除该节点并不再处理
-			dist.erase(u);
-			continue;
-		}
-
-		// 修复：检查节点是否存在邻接表
-		auto u_it = GTemp.find(u);
-		if (u_it == GTemp.end()) continue;
-
-		const auto& neighbors = u_it->second;
-		for (const auto& edge : neighbors) {
-			int v = edge.first;
-			const auto& attrs = edge.second;
-
-			// 提取权重
-			double weight = 1.0;
-			auto attr_it = attrs.find(weight_name);
-			if (attr_it != attrs.end()) {
-				weight = attr_it->second;
-			}
-			else {
-				// 可选：抛出异常或记录日志
-				// throw runtime_error("Weight '" + weight_name + "' missing");
-			}
+		if (d > ws.dist[u]) continue;
+		if (remaining > 0 && ws.settle_target(u) && --remaining == 0) break; // 目标全部确定
+		if (d > cut_off) break; // 之后弹出的距离均超过cut_off
 
-			double new_dist = d + weight;
-			if (!dist.count(v) || new_dist < dist[v]) {
-				dist[v] = new_dist;
-				pq.emplace(new_dist, v);
-			}
-		}
+		g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+			relax(v, d + w, u);
+		});
 	}
 
-	return dist;
+	// 剔除超过 cut_off 的节点
+	filter_cut_off(result, cut_off);
+	return result;
 };
 
 
-// 非全勤权重邻接字典获取
-unordered_map<int, vector<pair<int, double>>> GraphAlgorithms::weight_reverse_func(
-	string weight_name)
+SearchResult GraphAlgorithms::multi_source_dijkstra_cost_centroid(
+	const CSRGraph& g,
+	int weight_index,
+	const vector<int>& sources,
+	const vector<int>& targets,
+	double cut_off,
+	const string& weight_name,
+	QueueKind queue)
 {
-	unordered_map<int, vector<pair<int, double>>> res_G;
-	for (auto& entry : G) {
-		int u = entry.first;
-		auto& edges = entry.second;
-		for (auto& edge : edges) {
-			int v = edge.first;
-			auto& attrs = edge.second;
-			double weight = 1.0;
-			auto attr_it = attrs.find(weight_name);
-			if (attr_it != attrs.end()) {
-				weight = attr_it->second;
-			}
-
-			res_G[v].emplace_back(u, weight);
-		}
+	switch (queue) {
+	case QueueKind::QuadHeap:
+		return dijkstra_search_centroid<QuadHeap>(g, weight_index, sources, targets, cut_off, weight_name);
+	case QueueKind::Radix:
+		return dijkstra_search_centroid<RadixHeap>(g, weight_index, sources, targets, cut_off, weight_name);
+	case QueueKind::Dial:
+		return dijkstra_search_centroid<BucketQueue>(g, weight_index, sources, targets, cut_off, weight_name);
+	default:
+		return dijkstra_search_centroid<MinHeap>(g, weight_index, sources, targets, cut_off, weight_name);
 	}
-
-	return res_G;
 }
 
 
-// 非全勤权重前导字典获取
-unordered_map<int, vector<pair<int, double>>> GraphAlgorithms::weight_func(
-	string weight_name)
+SearchResult GraphAlgorithms::multi_source_dijkstra_cost_centroid(
+	const CSRGraph& g,
+	int weight_index,
+	const vector<int>& sources,
+	int target,
+	double cut_off,
+	const string& weight_name,
+	QueueKind queue)
 {
-	unordered_map<int, vector<pair<int, double>>> res_G;
-	for (auto& entry : G) {
-		int u = entry.first;
-		auto& edges = entry.second;
-		for (auto& edge : edges) {
-			int v = edge.first;
-			auto& attrs = edge.second;
-			double weight = 1.0;
-			auto attr_it = attrs.find(weight_name);
-			if (attr_it != attrs.end()) {
-				weight = attr_it->second;
-			}
-
-			res_G[u].emplace_back(v, weight);
-		}
-	}
-
-	return res_G;
+	return multi_source_dijkstra_cost_centroid(g, weight_index, sources, target == -1 ? vector<int>() : vector<int>{ target }, cut_off, weight_name, queue);
 }
 
 
-// 获取正向权重
-const unordered_map<int, vector<pair<int, double>>>&
-GraphAlgorithms::get_weight_map(const string& weight_name)
+// 剔除超过 cut_off 的节点
+void GraphAlgorithms::filter_cut_off(
+	SearchResult& result,
+	double cut_off)
 {
-	// 检查 weight_name 是否存在于 field_vec
-	auto field_it = find(field_vec.begin(), field_vec.end(), weight_name);
-	if (field_it != field_vec.end()) {
-		// 直接返回 full_field_map 中对应位置的引用
-		int field_index = distance(field_vec.begin(), field_it);
-		return full_field_map[field_index]; // 返回常引用
-	}
-	else {
-		// 若未找到，调用 weight_func 并返回其结果的引用（假设 weight_func 返回持久对象）
-		static auto cached_map = weight_func(weight_name); // 静态缓存（可选）
-		return cached_map; // 需根据 weight_func 的实际行为调整
+	auto& touched = result.touched;
+	size_t kept = 0;
+	for (int v : touched) {
+		if (result.dist(v) <= cut_off) {
+			touched[kept++] = v;
+		}
+		else {
+			result.workspace->clear(v);
+		}
 	}
+	touched.resize(kept);
 }
 
 
-// 获取反向权重
-const unordered_map<int, vector<pair<int, double>>>&
-GraphAlgorithms::get_weight_reverse_map(const string& weight_name)
+// 双向目标导向搜索：两方向的约化边权 w(u, v) - p(u) + p(v) 相同，p 一致时非负；
+// 正反两侧的最小键之和中势函数相互抵消，不小于已知最优花费时停止
+template <typename Potential>
+dis_and_path GraphAlgorithms::bidirectional_goal_search(
+	const CSRGraph& g,
+	int weight_index,
+	int source,
+	int target,
+	double cut_off,
+	const Potential& potential,
+	const set<int>& ignore_nodes,
+	const set<pair<int, int>>& ignore_edges)
 {
-	// 检查 weight_name 是否存在于 field_vec
-	auto field_it = find(field_vec.begin(), field_vec.end(), weight_name);
-	if (field_it != field_vec.end()) {
-		// 直接返回 full_field_map 中对应位置的引用
-		int field_index = distance(field_vec.begin(), field_it);
-		return full_field_reverse_map[field_index]; // 返回常引用
-	}
-	else {
-		// 若未找到，调用 weight_func 并返回其结果的引用（假设 weight_func 返回持久对象）
-		static auto cached_map = weight_reverse_func(weight_name); // 静态缓存（可选）
-		return cached_map; // 需根据 weight_func 的实际行为调整
+	dis_and_path result;
+	const double inf = numeric_limits<double>::infinity();
+	if (source == target) {
+		result.cost.emplace(target, 0.0);
+		result.paths.emplace(target, vector<int>{ source });
+		return result;
 	}
-}
 
+	SearchWorkspace& forward = SearchWorkspace::local(0);
+	SearchWorkspace& backward = SearchWorkspace::local(1);
+	forward.reset(g.num_nodes);
+	backward.reset(g.num_nodes);
+	MinHeap pq_forward(forward);
+	MinHeap pq_backward(backward);
 
-// 构建反向图的邻接表
-unordered_map<int, vector<pair<int, double>>> build_reverse_graph(
-	const unordered_map<int, vector<pair<int, double>>>& g)
-{
-	unordered_map<int, vector<pair<int, double>>> reverse_g;
-	for (auto it = g.begin(); it != g.end(); ++it) {
-		int u = it->first;
-		const auto& neighbors = it->second;  // 获取 u 的邻居
+	forward.set(source, 0.0, -1);
+	pq_forward.emplace(static_cast<cost_t>(potential(source)), source);
+	backward.set(target, 0.0, -1);
+	pq_backward.emplace(static_cast<cost_t>(-potential(target)), target);
+
+	cost_t best_cost = inf;
+	int meet_node = -1;
+	const bool has_ignore = !ignore_nodes.empty() || !ignore_edges.empty(); // 无 ignore 时跳过集合查找
+
+	while (!pq_forward.empty() && !pq_backward.empty()) {
+		// 终止条件：两方向最小键之和不小于已知最优
+		if (pq_forward.top().first + pq_backward.top().first >= best_cost) {
+			break;
+		}
+
+		if (pq_forward.top().first <= pq_backward.top().first) {
+			// 正向扩展，键与当前花费不一致即为过时条目
+			auto top = pq_forward.top();
+			int u = top.second;
+			pq_forward.pop();
+			if (top.first > static_cast<cost_t>(forward.dist[u] + potential(u)) || (has_ignore && ignore_nodes.count(u))) continue;
+			const cost_t d = forward.dist[u];
+			if (d > cut_off) continue;
+
+			g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+				if (has_ignore && (ignore_nodes.count(v) || ignore_edges.count({ u, v }))) return;
+
+				const cost_t new_dist = d + w;
+				if (new_dist < forward.get(v)) {
+					forward.set(v, new_dist, u);
+					pq_forward.emplace(static_cast<cost_t>(new_dist + potential(v)), v);
+				}
+				// 相遇检查
+				if (forward.get(v) + backward.get(v) < best_cost) {
+					best_cost = forward.get(v) + backward.get(v);
+					meet_node = v;
+				}
+			});
+		}
+		else {
+			// 反向扩展
+			auto top = pq_backward.top();
+			int u = top.second;
+			pq_backward.pop();
+			if (top.first > static_cast<cost_t>(backward.dist[u] - potential(u)) || (has_ignore && ignore_nodes.count(u))) continue;
+			const cost_t d = backward.dist[u];
+			if (d > cut_off) continue;
+
+			g.for_each_in(u, weight_index, [&](int v, weight_t w) {
+				if (has_ignore && (ignore_nodes.count(v) || ignore_edges.count({ v, u }))) return;
+
+				const cost_t new_dist = d + w;
+				if (new_dist < backward.get(v)) {
+					backward.set(v, new_dist, u);
+					pq_backward.emplace(static_cast<cost_t>(new_dist - potential(v)), v);
+				}
+				// 相遇检查
+				if (forward.get(v) + backward.get(v) < best_cost) {
+					best_cost = forward.get(v) + backward.get(v);
+					meet_node = v;
+				}
+			});
+		}
+	}
 
-		for (auto jt = neighbors.begin(); jt != neighbors.end(); ++jt) {
-			int v = jt->first;
-			double w = jt->second;  // 获取 v 和权重 w
-			reverse_g[v].emplace_back(u, w);  // 反向边：v ← u
+	// 路径重构：正向路径 + 反向路径[1:]
+	if (meet_node != -1 && best_cost <= cut_off) {
+		vector<int> path;
+		for (int u = meet_node; u != -1; u = forward.pred[u]) {
+			path.push_back(u);
 		}
+		reverse(path.begin(), path.end());
+		for (int u = backward.pred[meet_node]; u != -1; u = backward.pred[u]) {
+			path.push_back(u);
+		}
+		result.cost.emplace(target, best_cost);
+		result.paths.emplace(target, path);
+	}
+	else {
+		result.cost.emplace(target, inf);
+		result.paths.emplace(target, vector<int>{});
 	}
-	return reverse_g;
+	return result;
 }
 
 
 // 双向Dijkstra算法
 dis_and_path GraphAlgorithms::bidirectional_dijkstra(
-	const unordered_map<int, vector<pair<int, double>>>& reverse_g,
-	const unordered_map<int, vector<pair<int, double>>>& g,
+	const CSRGraph& g,
+	int weight_index,
 	const vector<int>& sources,
 	int target,
-	double cut_off)
+	double cut_off,
+	const LandmarkIndex* landmarks)
+{
+	set<int> ignore_nodes;
+	set<pair<int, int>> ignore_edges;
+	return bidirectional_dijkstra_ignore(g, weight_index, sources, target, cut_off, ignore_nodes, ignore_edges, landmarks);
+}
+
+
+// 双向Dijkstra算法 有ignore边（源点、终点及 ignore 集合均为内部索引）
+dis_and_path GraphAlgorithms::bidirectional_dijkstra_ignore(
+	const CSRGraph& g,
+	int weight_index,
+	const vector<int>& sources,
+	int target,
+	double cut_off,
+	const set<int>& ignore_nodes,
+	const set<pair<int, int>>& ignore_edges,
+	const LandmarkIndex* landmarks)
 {
 	// 结果存储结构
 	dis_and_path result;
@@ -412,134 +3273,123 @@ dis_and_path GraphAlgorithms::bidirectional_dijkstra(
 		}
 	}
 
-	// 正向搜索数据结构
-	std::unordered_map<int, double> dist_forward;
-	std::unordered_map<int, int> pred_forward;
-	std::priority_queue<std::pair<double, int>,
-		std::vector<std::pair<double, int>>,
-		std::greater<>> pq_forward;
+	// 单源且有路标索引：势函数 p(v) = (lb(v, 终点) - lb(起点, v)) / 2
+	if (landmarks != nullptr && sources.size() == 1) {
+		int source = sources[0];
+		auto potential = [&](int v) {
+			return (landmarks->lower_bound(v, target) - landmarks->lower_bound(source, v)) / 2.0;
+		};
+		return bidirectional_goal_search(g, weight_index, source, target, cut_off, potential, ignore_nodes, ignore_edges);
+	}
+
+	const double inf = numeric_limits<double>::infinity();
 
-	// 反向搜索数据结构
-	std::unordered_map<int, double> dist_backward;
-	std::unordered_map<int, int> pred_backward;
-	std::priority_queue<std::pair<double, int>,
-		std::vector<std::pair<double, int>>,
-		std::greater<>> pq_backward;
+	// 正向、反向搜索各用一个工作区
+	SearchWorkspace& forward = SearchWorkspace::local(0);
+	SearchWorkspace& backward = SearchWorkspace::local(1);
+	forward.reset(g.num_nodes);
+	backward.reset(g.num_nodes);
+	MinHeap pq_forward(forward);
+	MinHeap pq_backward(backward);
 
 	// 初始化正向搜索
 	for (int s : sources) {
-		if (g.count(s)) {
-			dist_forward[s] = 0.0;
-			pred_forward[s] = -1;
-			pq_forward.emplace(0.0, s);
-		}
+		forward.set(s, 0.0, -1);
+		pq_forward.emplace(0.0, s);
 	}
 
 	// 初始化反向搜索
-	dist_backward[target] = 0.0;
-	pred_backward[target] = -1;
+	backward.set(target, 0.0, -1);
 	pq_backward.emplace(0.0, target);
 
 	// 最优路径跟踪
-	double best_cost = std::numeric_limits<double>::max();
+	cost_t best_cost = inf;
 	int meet_node = -1;
+	const bool has_ignore = !ignore_nodes.empty() || !ignore_edges.empty(); // 无 ignore 时跳过集合查找
 
 	// 交替扩展策略
 	while (!pq_forward.empty() && !pq_backward.empty()) {
+		// 终止条件：当前最小距离之和超过已知最优
+		if (pq_forward.top().first + pq_backward.top().first >= best_cost) {
+			break;
+		}
+
 		// 选择当前更小的队列扩展
 		if (pq_forward.top().first <= pq_backward.top().first) {
 			// 正向扩展
 			auto top = pq_forward.top();
-			double d = top.first;
+			cost_t d = top.first;
 			int u = top.second;
 			pq_forward.pop();
 
-			if (d > dist_forward[u]) continue;
+			// 忽略已访问节点或被忽略的节点
+			if (d > forward.dist[u] || (has_ignore && ignore_nodes.count(u))) continue;
 			if (d > cut_off) continue;
 
-			// 提前终止检查
-			if (dist_backward.count(u) && (d + dist_backward[u] < best_cost)) {
-				best_cost = d + dist_backward[u];
-				meet_node = u;
-			}
-
-			auto it = g.find(u);
-			if (it == g.end()) continue;
+			g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+				// 忽略被忽略的节点和边（原图中的u→v）
+				if (has_ignore && (ignore_nodes.count(v) || ignore_edges.count({ u, v }))) return;
 
-			for (const auto&pair : it->second) {
-				auto v = pair.first;
-				auto w = pair.second;
-				const double new_dist = d + w;
-				if (!dist_forward.count(v) || new_dist < dist_forward[v]) {
-					dist_forward[v] = new_dist;
-					pred_forward[v] = u;
+				const cost_t new_dist = d + w;
+				if (new_dist < forward.get(v)) {
+					forward.set(v, new_dist, u);
 					pq_forward.emplace(new_dist, v);
 				}
-			}
+				// 相遇检查
+				if (forward.get(v) + backward.get(v) < best_cost) {
+					best_cost = forward.get(v) + backward.get(v);
+					meet_node = v;
+				}
+			});
 		}
 		else {
 			// 反向扩展
 			auto top = pq_backward.top();
-			double d = top.first;
+			cost_t d = top.first;
 			int u = top.second;
-
 			pq_backward.pop();
 
-			if (d > dist_backward[u]) continue;
+			// 忽略已访问节点或被忽略的节点
+			if (d > backward.dist[u] || (has_ignore && ignore_nodes.count(u))) continue;
 			if (d > cut_off) continue;
 
-			// 提前终止检查
-			if (dist_forward.count(u) && (d + dist_forward[u] < best_cost)) {
-				best_cost = d + dist_forward[u];
-				meet_node = u;
-			}
-
-			auto it = reverse_g.find(u);
-			if (it == reverse_g.end()) continue;
+			g.for_each_in(u, weight_index, [&](int v, weight_t w) {
+				// 忽略被忽略的节点和边（原图中的v→u）
+				if (has_ignore && (ignore_nodes.count(v) || ignore_edges.count({ v, u }))) return;
 
-			for (const auto&pair : it->second) {
-				auto v = pair.first;
-				auto w = pair.second;
-				const double new_dist = d + w;
-				if (!dist_backward.count(v) || new_dist < dist_backward[v]) {
-					dist_backward[v] = new_dist;
-					pred_backward[v] = u;
+				const cost_t new_dist = d + w;
+				if (new_dist < backward.get(v)) {
+					backward.set(v, new_dist, u);
 					pq_backward.emplace(new_dist, v);
 				}
-			}
-		}
-
-		// 终止条件：当前最小距离之和超过已知最优
-		if (pq_forward.top().first + pq_backward.top().first >= best_cost) {
-			break;
+				// 相遇检查
+				if (forward.get(v) + backward.get(v) < best_cost) {
+					best_cost = forward.get(v) + backward.get(v);
+					meet_node = v;
+				}
+			});
 		}
 	}
 
 	// 路径重构
-	if (meet_node != -1) {
+	if (meet_node != -1 && best_cost <= cut_off) {
 		// 正向路径回溯
 		std::vector<int> forward_path;
-		for (int u = meet_node; u != -1; u = pred_forward[u]) {
+		for (int u = meet_node; u != -1; u = forward.pred[u]) {
 			forward_path.push_back(u);
 		}
 		std::reverse(forward_path.begin(), forward_path.end());
 
-		// 反向路径回溯
-		std::vector<int> backward_path;
-		for (int u = meet_node; u != -1; u = pred_backward[u]) {
-			backward_path.push_back(u);
+		// 反向路径回溯，合并路径（正向路径 + 反向路径[1:]）
+		for (int u = backward.pred[meet_node]; u != -1; u = backward.pred[u]) {
+			forward_path.push_back(u);
 		}
 
-		// 合并路径
-		forward_path.insert(forward_path.end(),
-			backward_path.begin() + 1,
-			backward_path.end());
-
 		result.cost.emplace(target, best_cost);
 		result.paths.emplace(target, forward_path);
 	}
 	else {
-		result.cost.emplace(target, numeric_limits<double>::infinity());
+		result.cost.emplace(target, inf);
 		result.paths.emplace(target, std::vector<int>{});
 	}
 
@@ -547,195 +3397,295 @@ dis_and_path GraphAlgorithms::bidirectional_dijkstra(
 }
 
 
-// 双向Dijkstra算法 有ignore边
-dis_and_path GraphAlgorithms::bidirectional_dijkstra_ignore(
-	const unordered_map<int, vector<pair<int, double>>>& reverse_g,
-	const unordered_map<int, vector<pair<int, double>>>& g,
-	const vector<int>& sources,
+// 检查 A* 所需坐标（结果按图版本与坐标版本缓存）
+void GraphAlgorithms::check_astar(
+	double max_speed)
+{
+	if (!(max_speed > 0.0) || std::isinf(max_speed)) {
+		throw runtime_error("max_speed must be a positive number");
+	}
+	if (node_x.empty()) {
+		throw runtime_error("node coordinates are not set, call set_node_coords first");
+	}
+	if (coord_check_graph != graph_version || coord_check_coord != coord_version) {
+		coords_complete = true;
+		int num_nodes = static_cast<int>(node_ids.size());
+		for (int u = 0; u < num_nodes; ++u) {
+			if (!has_coord(u) && !is_centroid(u)) {
+				coords_complete = false;
+				break;
+			}
+		}
+		coord_check_graph = graph_version;
+		coord_check_coord = coord_version;
+	}
+	if (!coords_complete) {
+		throw runtime_error("A* requires coordinates on every node, call set_node_coords first");
+	}
+}
+
+
+// A*算法：边权不小于两端直线距离 / max_speed 时启发值一致，每个节点只确定一次
+dis_and_path GraphAlgorithms::astar(
+	const CSRGraph& g,
+	int weight_index,
+	int source,
 	int target,
-	double cut_off,
-	const set<int>& ignore_nodes,
-	const set<pair<int, int>>& ignore_edges)
+	double max_speed)
 {
-	// 结果存储结构
 	dis_and_path result;
+	const double inf = numeric_limits<double>::infinity();
+	if (source == target) {
+		result.cost.emplace(target, 0.0);
+		result.paths.emplace(target, vector<int>{ source });
+		return result;
+	}
+
+	// 启发值：到终点的直线距离 / max_speed
+	const double tx = node_x[target];
+	const double ty = node_y[target];
+	auto h = [&](int v) {
+		return hypot(node_x[v] - tx, node_y[v] - ty) / max_speed;
+	};
+
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	ws.reset(g.num_nodes);
+	MinHeap pq(ws);
+	ws.set(source, 0.0, -1);
+	pq.emplace(static_cast<cost_t>(h(source)), source);
+
+	bool found = false;
+	while (!pq.empty()) {
+		auto top = pq.top();
+		int u = top.second;
+		pq.pop();
+
+		// 队列键为 花费 + 启发值，与当前花费对应的键不一致即为过时条目
+		if (top.first > static_cast<cost_t>(ws.dist[u] + h(u))) continue;
+		if (u == target) {
+			found = true;
+			break;
+		}
+
+		const cost_t d = ws.dist[u];
+		g.for_each_out(u, weight_index, [&](int v, weight_t w) {
+			const cost_t new_dist = d + w;
+			if (new_dist < ws.get(v)) {
+				ws.set(v, new_dist, u);
+				pq.emplace(static_cast<cost_t>(new_dist + h(v)), v);
+			}
+		});
+	}
 
-	// 检查目标是否是源节点
-	for (int s : sources) {
-		if (s == target) {
-			result.cost.emplace(s, 0.0);
-			result.paths.emplace(s, std::vector<int>{s});
-			return result;
+	if (found) {
+		vector<int> path;
+		for (int u = target; u != -1; u = ws.pred[u]) {
+			path.push_back(u);
 		}
+		reverse(path.begin(), path.end());
+		result.cost.emplace(target, ws.dist[target]);
+		result.paths.emplace(target, path);
+	}
+	else {
+		result.cost.emplace(target, inf);
+		result.paths.emplace(target, vector<int>{});
 	}
+	return result;
+}
 
-	// 正向搜索数据结构
-	std::unordered_map<int, double> dist_forward;
-	std::unordered_map<int, int> pred_forward;
-	std::priority_queue<std::pair<double, int>,
-		std::vector<std::pair<double, int>>,
-		std::greater<>> pq_forward;
 
-	// 反向搜索数据结构
-	std::unordered_map<int, double> dist_backward;
-	std::unordered_map<int, int> pred_backward;
-	std::priority_queue<std::pair<double, int>,
-		std::vector<std::pair<double, int>>,
-		std::greater<>> pq_backward;
+// 双向A*算法：势函数 p(v) = (到终点的启发值 - 到起点的启发值) / 2
+dis_and_path GraphAlgorithms::bidirectional_astar(
+	const CSRGraph& g,
+	int weight_index,
+	int source,
+	int target,
+	double max_speed)
+{
+	const double sx = node_x[source];
+	const double sy = node_y[source];
+	const double tx = node_x[target];
+	const double ty = node_y[target];
+	auto potential = [&](int v) {
+		double to_target = hypot(node_x[v] - tx, node_y[v] - ty);
+		double to_source = hypot(node_x[v] - sx, node_y[v] - sy);
+		return (to_target - to_source) / (2.0 * max_speed);
+	};
 
-	// 初始化正向搜索
-	for (int s : sources) {
-		if (g.count(s)) {
-			dist_forward[s] = 0.0;
-			pred_forward[s] = -1;
-			pq_forward.emplace(0.0, s);
-		}
+	set<int> ignore_nodes;
+	set<pair<int, int>> ignore_edges;
+	return bidirectional_goal_search(g, weight_index, source, target, numeric_limits<double>::infinity(),
+		potential, ignore_nodes, ignore_edges);
+}
+
+
+// 收缩层次上的点到点查询：正向沿向上弧、反向沿向下弧各自只向 rank 更高的节点扩展，
+// 一侧最小键不小于已知最优时该侧停止，两侧均停止后沿相遇节点展开捷径
+dis_and_path GraphAlgorithms::ch_query(
+	const ContractionHierarchy& ch,
+	int weight_index,
+	int source,
+	int target)
+{
+	dis_and_path result;
+	const double inf = numeric_limits<double>::infinity();
+	if (source == target) {
+		result.cost.emplace(target, 0.0);
+		result.paths.emplace(target, vector<int>{ source });
+		return result;
 	}
 
-	// 初始化反向搜索
-	dist_backward[target] = 0.0;
-	pred_backward[target] = -1;
+	const int n = static_cast<int>(ch.rank.size());
+	SearchWorkspace& forward = SearchWorkspace::local(0);
+	SearchWorkspace& backward = SearchWorkspace::local(1);
+	forward.reset(n);
+	backward.reset(n);
+	MinHeap pq_forward(forward);
+	MinHeap pq_backward(backward);
+	forward.set(source, 0.0, -1);
+	pq_forward.emplace(0.0, source);
+	backward.set(target, 0.0, -1);
 	pq_backward.emplace(0.0, target);
 
-	// 最优路径跟踪
-	double best_cost = std::numeric_limits<double>::max();
+	cost_t best_cost = inf;
 	int meet_node = -1;
+	auto meet = [&](int v) {
+		if (forward.get(v) + backward.get(v) < best_cost) {
+			best_cost = forward.get(v) + backward.get(v);
+			meet_node = v;
+		}
+	};
 
-	// 交替扩展策略
-	while (!pq_forward.empty() && !pq_backward.empty()) {
-		// 选择当前更小的队列扩展
-		if (pq_forward.top().first <= pq_backward.top().first) {
-			// 正向扩展
+	while (true) {
+		bool forward_open = !pq_forward.empty() && pq_forward.top().first < best_cost;
+		bool backward_open = !pq_backward.empty() && pq_backward.top().first < best_cost;
+		if (!forward_open && !backward_open) break;
+
+		if (forward_open && (!backward_open || pq_forward.top().first <= pq_backward.top().first)) {
 			auto top = pq_forward.top();
-			double d = top.first;
 			int u = top.second;
 			pq_forward.pop();
-
-			// 忽略已访问节点或被忽略的节点
-			if (d > dist_forward[u] || ignore_nodes.count(u)) continue;
-			if (d > cut_off) continue;
-
-			// 提前终止检查
-			if (dist_backward.count(u) && (d + dist_backward[u] < best_cost)) {
-				best_cost = d + dist_backward[u];
-				meet_node = u;
-			}
-
-			auto it = g.find(u);
-			if (it == g.end()) continue;
-
-			for (const auto& pair : it->second) {
-				auto v = pair.first;
-				auto w = pair.second;
-
-				// 忽略被忽略的边（原图中的u→v）
-				if (ignore_edges.count({ u, v })) continue;
-
-				const double new_dist = d + w;
-				if (!dist_forward.count(v) || new_dist < dist_forward[v]) {
-					dist_forward[v] = new_dist;
-					pred_forward[v] = u;
+			if (top.first > forward.dist[u]) continue;
+			meet(u);
+			for (int p = ch.up_offset[u]; p < ch.up_offset[u + 1]; ++p) {
+				int v = ch.up_target[p];
+				const cost_t new_dist = top.first + ch.up_weight[p];
+				if (new_dist < forward.get(v)) {
+					forward.set(v, new_dist, u);
 					pq_forward.emplace(new_dist, v);
 				}
 			}
 		}
 		else {
-			// 反向扩展
 			auto top = pq_backward.top();
-			double d = top.first;
 			int u = top.second;
 			pq_backward.pop();
-
-			// 忽略已访问节点或被忽略的节点
-			if (d > dist_backward[u] || ignore_nodes.count(u)) continue;
-			if (d > cut_off) continue;
-
-			// 提前终止检查
-			if (dist_forward.count(u) && (d + dist_forward[u] < best_cost)) {
-				best_cost = d + dist_forward[u];
-				meet_node = u;
-			}
-
-			auto it = reverse_g.find(u);
-			if (it == reverse_g.end()) continue;
-
-			for (const auto& pair : it->second) {
-				auto v = pair.first;
-				auto w = pair.second;
-
-				// 忽略被忽略的边（原图中的v→u）
-				if (ignore_edges.count({ v, u })) continue;
-
-				const double new_dist = d + w;
-				if (!dist_backward.count(v) || new_dist < dist_backward[v]) {
-					dist_backward[v] = new_dist;
-					pred_backward[v] = u;
+			if (top.first > backward.dist[u]) continue;
+			meet(u);
+			for (int p = ch.down_offset[u]; p < ch.down_offset[u + 1]; ++p) {
+				int v = ch.down_source[p];
+				const cost_t new_dist = top.first + ch.down_weight[p];
+				if (new_dist < backward.get(v)) {
+					backward.set(v, new_dist, u);
 					pq_backward.emplace(new_dist, v);
 				}
 			}
 		}
+	}
 
-		// 终止条件：当前最小距离之和超过已知最优，或任一队列为空
-		if (pq_forward.empty() || pq_backward.empty()) {
-			break;
-		}
-		if (pq_forward.top().first + pq_backward.top().first >= best_cost) {
-			break;
-		}
+	if (meet_node == -1) {
+		result.cost.emplace(target, inf);
+		result.paths.emplace(target, vector<int>{});
+		return result;
 	}
 
-	// 路径重构
-	if (meet_node != -1) {
-		// 正向路径回溯
-		std::vector<int> forward_path;
-		for (int u = meet_node; u != -1; u = pred_forward[u]) {
-			forward_path.push_back(u);
-		}
-		std::reverse(forward_path.begin(), forward_path.end());
+	// 正向弧链 source..meet 与反向弧链 meet..target 依次展开
+	vector<int> hops;
+	for (int u = meet_node; u != -1; u = forward.pred[u]) {
+		hops.push_back(u);
+	}
+	reverse(hops.begin(), hops.end());
+	for (int u = backward.pred[meet_node]; u != -1; u = backward.pred[u]) {
+		hops.push_back(u);
+	}
+	vector<int> path{ source };
+	for (size_t i = 1; i < hops.size(); ++i) {
+		ch.unpack(hops[i - 1], hops[i], path);
+	}
 
-		// 反向路径回溯
-		std::vector<int> backward_path;
-		for (int u = meet_node; u != -1; u = pred_backward[u]) {
-			backward_path.push_back(u);
-		}
+	// 花费沿原图路径从起点依次累加（与 Dijkstra 相同，不受捷径求和顺序影响）
+	result.cost.emplace(target, calculate_path_length(csr, weight_index, path));
+	result.paths.emplace(target, path);
+	return result;
+}
 
-		// 合并路径（正向路径 + 反向路径[1:]）
-		if (!backward_path.empty()) {
-			forward_path.insert(forward_path.end(),
-				backward_path.begin() + 1, backward_path.end());
-		}
 
-		result.cost.emplace(target, best_cost);
-		result.paths.emplace(target, forward_path);
+// 多层覆盖图上的点到点查询：起点与终点所在单元内走原图边，其余单元按最高可用层走团弧，找到后逐层展开
+dis_and_path GraphAlgorithms::crp_query(
+	const MultilevelOverlay& ov,
+	const OverlayMetric& metric,
+	int weight_index,
+	int source,
+	int target)
+{
+	dis_and_path result;
+	const CSRGraph& g = csr;
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	const vector<pair<int, cost_t>> seeds{ { source, 0.0 } };
+	OverlayLevels levels(ov, seeds, { target });
+	overlay_search(g, weight_index, ov, metric, levels, seeds, { target }, numeric_limits<double>::infinity(), ws);
+	if (!ws.reached(target)) {
+		result.cost.emplace(target, numeric_limits<double>::infinity());
+		result.paths.emplace(target, vector<int>{});
+		return result;
 	}
-	else {
-		result.cost.emplace(target, std::numeric_limits<double>::infinity());
-		result.paths.emplace(target, std::vector<int>{});
+
+	// 覆盖图上的弧序列（展开时复用工作区前先取出）
+	vector<int> hops;
+	for (int u = target; u != -1; u = ws.pred[u]) {
+		hops.push_back(u);
+	}
+	reverse(hops.begin(), hops.end());
+	vector<int> path{ source };
+	for (size_t i = 1; i < hops.size(); ++i) {
+		int l = levels.level(hops[i - 1]);
+		if (l > 0 && ov.cell(l, hops[i - 1]) == ov.cell(l, hops[i])) {
+			unpack_overlay_arc(g, weight_index, ov, metric, l, hops[i - 1], hops[i], path);
+		}
+		else {
+			path.push_back(hops[i]);
+		}
 	}
 
+	result.cost.emplace(target, calculate_path_length(g, weight_index, path));
+	result.paths.emplace(target, path);
 	return result;
 }
 
 
-// 计算指定路径长度
+// 计算指定路径长度（路径为内部索引）
 double GraphAlgorithms::calculate_path_length(
-	const unordered_map<int, vector<pair<int, double>>>& g,
-	const vector<int>& path,
-	const string& weight) {
+	const CSRGraph& g,
+	int weight_index,
+	const vector<int>& path)
+{
+	const auto& weight = g.out_weight[weight_index];
 	double len = 0;
 
 	// 遍历路径中的每一对相邻节点 (u, v)
-	for (size_t i = 0; i < path.size() - 1; ++i) {
+	for (size_t i = 0; i + 1 < path.size(); ++i) {
 		int u = path[i];
 		int v = path[i + 1];
 
-		// 在邻接表中查找边 (u, v) 并获取其权重
-		const auto& neighbors = g.at(u); // 获取节点 u 的邻接列表
-		for (const auto& neighbor : neighbors) {
-			if (neighbor.first == v) { // 找到与 v 相连的边
-				len += neighbor.second; // 加上边的权重
-				break;
-			}
+		// 先在基础 CSR 行内二分查找边 (u, v)，再查增量层
+		int e = g.find_base_edge(u, v);
+		if (e != -1) {
+			len += weight[e];
+			continue;
+		}
+		int delta = g.find_delta_edge(u, v);
+		if (delta != -1) {
+			len += g.delta_weight[weight_index][delta];
 		}
 	}
 
@@ -748,161 +3698,87 @@ vector<vector<int>> GraphAlgorithms::shortest_simple_paths_much(
 	int source,
 	int target,
 	int K,
-	const string& weight_name)
+	const string& weight_name,
+	const string& method)
 {
-	// 1.节点检查
-	if (G.find(source) == G.end()) {
+	// 1.节点检查（形心点不参与路径搜索）
+	int s = find_node(source);
+	int t = find_node(target);
+	if (s == -1 || is_centroid(s)) {
 		throw std::runtime_error("source node not in graph");
 	}
-	if (G.find(target) == G.end()) {
+	if (t == -1 || is_centroid(t)) {
 		throw std::runtime_error("target node not in graph");
 	}
 
-	// 2.初始化路径列表
+	// 2.权重获取（method 为 "ALT" 时首条路径与各偏离路径均以路标下界导向）
+	if (method != "Dijkstra" && method != "ALT") {
+		throw std::runtime_error("unsupported k shortest paths method '" + method + "'");
+	}
+	const LandmarkIndex* landmarks = method == "ALT" ? &get_landmarks(weight_name) : nullptr;
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+
+	// 3.初始化路径列表（内部索引）
 	std::vector<std::vector<int>> listA; // 存储已找到的路径
 	PathBuffer listB; // 存储候选路径
 	std::vector<int> prev_path; // 上一条路径
 
-	// 3.权重获取
-	const auto& weight_map = get_weight_map(weight_name);
-	const auto& reverse_map = get_weight_reverse_map(weight_name);
-	auto cur_weight_map = weight_map;
-	auto cur_reverse_map = reverse_map;
-
 	// 4.主循环：寻找最短简单路径
 	while (true) {
 
 		if (prev_path.empty()) {
 			// 如果 prev_path 是空，直接计算最短路径
-			auto result = multi_source_dijkstra(weight_map, { source }, target, std::numeric_limits<double>::infinity(), weight_name);
+			auto result = bidirectional_dijkstra(g, weight_index, { s }, t, std::numeric_limits<double>::infinity(), landmarks);
 
 			// 检查目标节点是否可达
-			if (result.cost.find(target) != result.cost.end() && result.cost[target] < std::numeric_limits<double>::infinity()) {
-				double length = result.cost[target];
-				std::vector<int> path = result.paths[target];
-				listB.push(length, path);
+			if (result.cost[t] < std::numeric_limits<double>::infinity()) {
+				listB.push(result.cost[t], result.paths[t]);
 			}
 			else {
 				throw runtime_error("Target node is unreachable");
 			}
 		}
 		else {
+			// 被移除的边和点在快照上以 ignore 集合表示，无需复制整张权重表
 			std::set<int> ignore_nodes;
 			std::set<pair<int, int>> ignore_edges;
 
-			unordered_map<int, vector<pair<int, double>>> temp_g;
-			unordered_map<int, vector<pair<int, double>>> temp_reverse_g;
-
 			// 5.遍历前缀路径，更新 ignore_edges 和 ignore_nodes
 			for (size_t i = 1; i < prev_path.size(); ++i) {
 				std::vector<int> root(prev_path.begin(), prev_path.begin() + i);
-				double root_length = calculate_path_length(weight_map, root, weight_name);
+				double root_length = calculate_path_length(g, weight_index, root);
 
-				// 遍历 listA，避免重复路径
+				// 遍历 listA，移除与前缀重合路径的下一条边
 				for (const auto& path : listA) {
-					if (equal(root.begin(), root.end(), path.begin())) {
+					if (path.size() > i && equal(root.begin(), root.end(), path.begin())) {
 						ignore_edges.insert({ path[i - 1], path[i] });
-
-						int u = path[i - 1];
-						int v = path[i];
-
-						// 更新 正向图
-						if (weight_map.find(u) != weight_map.end()) {
-							auto& adj = cur_weight_map[u];
-							for (auto it = adj.begin(); it != adj.end(); ) {
-								if (it->first == v) {
-									// 将边 (u, v) 从 cur_weight_map 删除之前，先将其添加到 temp_G
-									double weight = it->second;  // 获取边的权重
-
-									// 检查 temp_G[u] 是否存在，如果不存在则创建一个空的 vector
-									if (temp_g.find(u) == temp_g.end()) {
-										temp_g[u] = vector<pair<int, double>>();  // 创建一个空的邻接表
-									}
-
-									// 将被删除的边 (u, v) 和权重添加到 temp_G 中
-									temp_g[u].push_back({ v, weight });
-
-									it = adj.erase(it);  // 删除并更新迭代器
-								}
-								else {
-									++it;  // 移动到下一个元素
-								}
-							}
-						}
-
-						// 更新 cur_reverse_map（反向图）
-						if (reverse_map.find(v) != reverse_map.end()) {
-							auto& adj_rev = cur_reverse_map[v];
-							for (auto it = adj_rev.begin(); it != adj_rev.end(); ) {
-								if (it->first == u) {
-									// 将边 (v, u) 从 cur_reverse_map 删除之前，先将其添加到 temp_G
-									double weight = it->second;  // 获取边的权重
-
-									// 检查 temp_G[v] 是否存在，如果不存在则创建一个空的 vector
-									if (temp_reverse_g.find(v) == temp_reverse_g.end()) {
-										temp_reverse_g[v] = vector<pair<int, double>>();  // 创建一个空的邻接表
-									}
-
-									// 将被删除的边 (v, u) 和权重添加到 temp_G 中
-									temp_reverse_g[v].push_back({ u, weight });
-
-									it = adj_rev.erase(it);  // 删除并更新迭代器
-								}
-								else {
-									++it;  // 移动到下一个元素
-								}
-							}
-						}
 					}
 				}
 
 				// 计算 spur path
-				try {
-					auto result = bidirectional_dijkstra(
-						cur_reverse_map,
-						cur_weight_map,
-						{ root.back() },
-						target,
-						numeric_limits<double>::infinity());
-
-					// 检查目标节点是否可达
-					if (result.cost.find(target) != result.cost.end() && result.cost[target] < std::numeric_limits<double>::infinity()) {
-						double length = result.cost[target];
-						vector<int> spur = result.paths[target];
-
-						// 组合路径
-						vector<int> impact_path = root;
-						impact_path.insert(impact_path.end(), spur.begin() + 1, spur.end());
-						listB.push(root_length + length, impact_path);
-					}
-					else {
-					}
-				}
-				catch (const std::exception& e) {
-				}
-
-				for (const auto& pair : cur_weight_map[root.back()]) {
-					temp_g[root.back()].push_back(pair);
-				}
-				for (const auto& pair : cur_reverse_map[root.back()]) {
-					temp_reverse_g[root.back()].push_back(pair);
+				auto result = bidirectional_dijkstra_ignore(
+					g,
+					weight_index,
+					{ root.back() },
+					t,
+					numeric_limits<double>::infinity(),
+					ignore_nodes,
+					ignore_edges,
+					landmarks);
+
+				// 检查目标节点是否可达
+				if (result.cost[t] < std::numeric_limits<double>::infinity()) {
+					const vector<int>& spur = result.paths[t];
+
+					// 组合路径
+					vector<int> impact_path = root;
+					impact_path.insert(impact_path.end(), spur.begin() + 1, spur.end());
+					listB.push(root_length + result.cost[t], impact_path);
 				}
 
-				cur_weight_map.erase(root.back());
-				cur_reverse_map.erase(root.back());
 				ignore_nodes.insert(root.back());
 			}
-			// 回溯移除的边和点
-			// 将 temp_G 中的元素合并到 cur_weight_map 中
-			for (const auto& pair : temp_g) {
-				// 对于 temp_G 中的每一个键值对，如果 cur_weight_map 中已经存在相同的键，合并其值
-				cur_weight_map[pair.first].insert(cur_weight_map[pair.first].end(), pair.second.begin(), pair.second.end());
-			}
-			// 将 temp_reverse_g 中的元素合并到 cur_reverse_map 中
-			for (const auto& pair : temp_reverse_g) {
-				// 对于 temp_G 中的每一个键值对，如果 cur_reverse_map 中已经存在相同的键，合并其值
-				cur_reverse_map[pair.first].insert(cur_reverse_map[pair.first].end(), pair.second.begin(), pair.second.end());
-			}
 		}
 
 		// 从 listB 中取出最短路径
@@ -921,7 +3797,12 @@ vector<vector<int>> GraphAlgorithms::shortest_simple_paths_much(
 		}
 	}
 
-	return vector<vector<int>>(listA.begin(), listA.begin() + K);
+	// 内部索引转回原始编号
+	vector<vector<int>> paths;
+	for (size_t i = 0; i < listA.size() && i < static_cast<size_t>(K); ++i) {
+		paths.push_back(path_to_external(listA[i]));
+	}
+	return paths;
 }
 
 
@@ -930,42 +3811,47 @@ vector<vector<int>> GraphAlgorithms::shortest_simple_paths_few(
 	int source,
 	int target,
 	int K,
-	const string& weight_name)
+	const string& weight_name,
+	const string& method)
 {
-	// 1.节点检查
-	if (G.find(source) == G.end()) {
+	// 1.节点检查（形心点不参与路径搜索）
+	int s = find_node(source);
+	int t = find_node(target);
+	if (s == -1 || is_centroid(s)) {
 		throw std::runtime_error("source node not in graph");
 	}
-	if (G.find(target) == G.end()) {
+	if (t == -1 || is_centroid(t)) {
 		throw std::runtime_error("target node not in graph");
 	}
 
-	// 2.初始化路径列表
+	// 2.权重获取（method 为 "ALT" 时首条路径与各偏离路径均以路标下界导向）
+	if (method != "Dijkstra" && method != "ALT") {
+		throw std::runtime_error("unsupported k shortest paths method '" + method + "'");
+	}
+	const LandmarkIndex* landmarks = method == "ALT" ? &get_landmarks(weight_name) : nullptr;
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = route_graph({ s, t }, weight_name, weight_index);
+
+	// 3.初始化路径列表（内部索引）
 	vector<vector<int>> listA; // 存储已找到的路径
 	PathBuffer listB; // 存储候选路径
 	vector<int> prev_path; // 上一条路径
 
-	// 3.权重获取
-	const auto& weight_map = get_weight_map(weight_name);
-	const auto& reverse_map = get_weight_reverse_map(weight_name);
-
-	double finale_time = 0.0;
 	// 4.主循环：寻找最短简单路径
 	while (true) {
 		if (prev_path.empty()) {
 			// 第一次最短路获取
-			auto result = multi_source_dijkstra(
-				weight_map,
-				{ source },
-				target,
+			auto result = bidirectional_dijkstra(
+				g,
+				weight_index,
+				{ s },
+				t,
 				std::numeric_limits<double>::infinity(),
-				weight_name);
+				landmarks);
 
 			// 检查目标节点是否可达
-			if (result.cost.find(target) != result.cost.end() && result.cost[target] < std::numeric_limits<double>::infinity()) {
-				double length = result.cost[target];
-				std::vector<int> path = result.paths[target];
-				listB.push(length, path);
+			if (result.cost[t] < std::numeric_limits<double>::infinity()) {
+				listB.push(result.cost[t], result.paths[t]);
 			}
 			else {
 				throw runtime_error("Target node is unreachable");
@@ -978,41 +3864,35 @@ vector<vector<int>> GraphAlgorithms::shortest_simple_paths_few(
 			// 5.遍历前缀路径，更新 ignore_edges 和 ignore_nodes
 			for (size_t i = 1; i < prev_path.size(); ++i) {
 				vector<int> root(prev_path.begin(), prev_path.begin() + i);
-				double root_length = calculate_path_length(weight_map, root, weight_name);
+				double root_length = calculate_path_length(g, weight_index, root);
 
 				// 遍历 listA，避免重复路径
 				for (const auto& path : listA) {
-					if (equal(root.begin(), root.end(), path.begin())) {
+					if (path.size() > i && equal(root.begin(), root.end(), path.begin())) {
 						ignore_edges.insert({ path[i - 1], path[i] });
 					}
 				}
 
-				// 计算 spur path
-				try {
-					// 双向Dijkstra计算最短路径 
-					auto result = bidirectional_dijkstra_ignore(
-						reverse_map,
-						weight_map,
-						{ root.back() },
-						target,
-						numeric_limits<double>::infinity(),
-						ignore_nodes,
-						ignore_edges);
-
-					if (result.cost.find(target) != result.cost.end() && result.cost[target] < numeric_limits<double>::infinity()) {
-						double length = result.cost[target];
-						vector<int> spur = result.paths[target];
-
-						// 组合路径
-						vector<int> impact_path = root;
-						impact_path.insert(impact_path.end(), spur.begin() + 1, spur.end());
-						listB.push(root_length + length, impact_path);
-					}
-					else {
-					}
-				}
-				catch (const exception& e) {
+				// 双向Dijkstra计算最短路径
+				auto result = bidirectional_dijkstra_ignore(
+					g,
+					weight_index,
+					{ root.back() },
+					t,
+					numeric_limits<double>::infinity(),
+					ignore_nodes,
+					ignore_edges,
+					landmarks);
+
+				if (result.cost[t] < numeric_limits<double>::infinity()) {
+					const vector<int>& spur = result.paths[t];
+
+					// 组合路径
+					vector<int> impact_path = root;
+					impact_path.insert(impact_path.end(), spur.begin() + 1, spur.end());
+					listB.push(root_length + result.cost[t], impact_path);
 				}
+
 				ignore_nodes.insert(root.back());
 			}
 
@@ -1029,63 +3909,454 @@ vector<vector<int>> GraphAlgorithms::shortest_simple_paths_few(
 			break;
 		}
 
-		// 判断是否已找到 K 条路径
-		if (listA.size() >= K) {
-			break;
-		}
-	}
+		// 判断是否已找到 K 条路径
+		if (listA.size() >= K) {
+			break;
+		}
+	}
+
+	// 内部索引转回原始编号
+	vector<vector<int>> paths;
+	for (size_t i = 0; i < listA.size() && i < static_cast<size_t>(K); ++i) {
+		paths.push_back(path_to_external(&g != &csr ? expand_path(listA[i]) : listA[i]));
+	}
+	return paths;
+}
+
+
+// 获取单个OD对的花费
+pair<double, vector<int>> GraphAlgorithms::single_source_to_target(
+	int source,
+	int target,
+	const string& weight_name,
+	const string& method,
+	double max_speed)
+{
+	// 1.节点检查（形心点不参与路径搜索）
+	int s = find_node(source);
+	int t = find_node(target);
+	if (s == -1 || is_centroid(s)) {
+		throw std::runtime_error("source node not in graph");
+	}
+	if (t == -1 || is_centroid(t)) {
+		throw std::runtime_error("target node not in graph");
+	}
+
+	const LandmarkIndex* landmarks = nullptr;
+	if (method == "AStar" || method == "BiAStar") {
+		check_astar(max_speed);
+	}
+	else if (method == "ALT") {
+		landmarks = &get_landmarks(weight_name);
+	}
+	else if (method == "CH") {
+		// 收缩层次建在快照上，路径无需展开收缩链
+		const ContractionHierarchy& ch = get_ch(weight_name);
+		int weight_index = get_weight_index(weight_name);
+		auto result = ch_query(ch, weight_index, s, t);
+		if (result.cost[t] < numeric_limits<double>::infinity()) {
+			return { result.cost[t], path_to_external(result.paths[t]) };
+		}
+		cout << "not find target path" << endl;
+		return { -1, { source } };
+	}
+	else if (method == "CRP") {
+		// 覆盖图同样建在快照上
+		const OverlayMetric& metric = get_overlay_metric(weight_name);
+		int weight_index = get_weight_index(weight_name);
+		auto result = crp_query(overlay, metric, weight_index, s, t);
+		if (result.cost[t] < numeric_limits<double>::infinity()) {
+			return { result.cost[t], path_to_external(result.paths[t]) };
+		}
+		cout << "not find target path" << endl;
+		return { -1, { source } };
+	}
+	else if (method != "Dijkstra") {
+		throw std::runtime_error("unsupported point-to-point method '" + method + "'");
+	}
+
+	// 2.权重获取
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = route_graph({ s, t }, weight_name, weight_index);
+
+	// 3.最短路径搜索（收缩图与快照节点索引一致，捷径权重为链上各边之和，启发值与路标下界仍然有效）
+	dis_and_path result;
+	if (method == "AStar") {
+		result = astar(g, weight_index, s, t, max_speed);
+	}
+	else if (method == "BiAStar") {
+		result = bidirectional_astar(g, weight_index, s, t, max_speed);
+	}
+	else {
+		result = bidirectional_dijkstra(
+			g,
+			weight_index,
+			{ s },
+			t,
+			numeric_limits<double>::infinity(),
+			landmarks);
+	}
+
+	if (result.cost[t] < numeric_limits<double>::infinity()) {
+		double length = result.cost[t];
+		vector<int> spur = path_to_external(&g != &csr ? expand_path(result.paths[t]) : result.paths[t]);
+		return {length, spur};
+	}
+	else {
+		cout << "not find target path" << endl;
+		double length = -1;
+		vector<int> spur;
+		spur.push_back(source);
+		return { length, spur };
+	}
+
+}
+
+// 各起点到各终点的路径：搜索至终点全部确定，只记录前驱，按终点回溯
+vector<vector<vector<int>>> GraphAlgorithms::paths_to_targets(
+	const vector<int>& starts,
+	const vector<int>& ends,
+	double cut_off,
+	const string& weight_name,
+	int num_thread,
+	QueueKind queue)
+{
+	vector<int> sources(starts.size());
+	vector<int> targets(ends.size());
+	for (size_t i = 0; i < starts.size(); ++i) sources[i] = find_node(starts[i]);
+	for (size_t j = 0; j < ends.size(); ++j) targets[j] = find_node(ends[j]);
+
+	int weight_index = get_weight_index(weight_name);
+	vector<int> endpoints;
+	for (int u : sources) {
+		if (u != -1) endpoints.push_back(u);
+	}
+	const CSRGraph& g = route_graph(endpoints, weight_name, weight_index);
+
+	// 搜索目标集：收缩图上位于链内部的终点由其所在链的起点代替
+	vector<int> route_targets;
+	if (&g == &csr) {
+		route_targets = targets;
+	}
+	else {
+		vector<char> interior_target(chains.interior.size(), 0);
+		for (int t : targets) {
+			if (t == -1) continue;
+			if (chains.interior[t]) interior_target[t] = 1;
+			else route_targets.push_back(t);
+		}
+		for (int s = 0; s < chains.num_chains(); ++s) {
+			for (int j = chains.chain_offset[s]; j < chains.chain_offset[s + 1]; ++j) {
+				if (interior_target[chains.chain_nodes[j]]) {
+					route_targets.push_back(chains.chain_from[s]);
+					break;
+				}
+			}
+		}
+	}
+
+	vector<vector<vector<int>>> paths(starts.size(), vector<vector<int>>(ends.size()));
+	size_t num_parts = thread_parts(starts.size(), num_thread);
+	parallel_parts(starts.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (sources[i] == -1) continue;
+			SearchResult search = multi_source_dijkstra_cost(g, weight_index, { sources[i] }, route_targets, cut_off, queue);
+			if (&g != &csr) expand_result(search, weight_index, cut_off);
+			for (size_t j = 0; j < targets.size(); ++j) {
+				int t = targets[j];
+				if (t != -1 && search.workspace->reached(t)) {
+					paths[i][j] = path_to_external(search.path(t));
+				}
+			}
+		}
+	});
+	return paths;
+}
+
+
+// 各组源点到目标集的花费：目标全部确定后即停止搜索
+vector<unordered_map<int, double>> GraphAlgorithms::costs_to_targets(
+	const vector<vector<int>>& list_o,
+	const vector<int>& targets,
+	double cut_off,
+	const string& weight_name,
+	int num_thread,
+	QueueKind queue,
+	bool centroid)
+{
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+
+	vector<unordered_map<int, double>> costs(list_o.size());
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (list_o[i].empty()) continue;
+			SearchResult search = centroid
+				? multi_source_dijkstra_cost_centroid(g, weight_index, list_o[i], targets, cut_off, weight_name, queue)
+				: multi_source_dijkstra_cost(g, weight_index, list_o[i], targets, cut_off, queue);
+			// 搜索在最后一个目标确定或超过 cut_off 时停止，已到达的目标花费均为最终值
+			for (int t : targets) {
+				if (t != -1 && search.workspace->reached(t)) {
+					costs[i][node_ids[t]] = search.dist(t);
+				}
+			}
+		}
+	});
+	return costs;
+}
+
+// 收缩层次上从 seeds 出发的向上搜索（offset/head/weight 取向上弧或向下弧），超过 cut_off 的节点不再扩展
+// 每个确定的节点调用 visit(节点, 花费)
+template <typename Visit>
+static void upward_search(
+	const vector<int>& offset,
+	const vector<int>& head,
+	const vector<cost_t>& weight,
+	const vector<pair<int, cost_t>>& seeds,
+	double cut_off,
+	int num_nodes,
+	Visit visit)
+{
+	SearchWorkspace& ws = SearchWorkspace::local(0);
+	ws.reset(num_nodes);
+	MinHeap pq(ws);
+	for (const auto& seed : seeds) {
+		if (seed.second < ws.get(seed.first)) {
+			ws.set(seed.first, seed.second, -1);
+			pq.emplace(seed.second, seed.first);
+		}
+	}
+
+	while (!pq.empty()) {
+		auto top = pq.top();
+		int u = top.second;
+		pq.pop();
+		if (top.first > ws.dist[u]) continue;
+		if (top.first > cut_off) break;
+		visit(u, top.first);
+		for (int p = offset[u]; p < offset[u + 1]; ++p) {
+			const cost_t new_dist = top.first + weight[p];
+			if (new_dist < ws.get(head[p])) {
+				ws.set(head[p], new_dist, u);
+				pq.emplace(new_dist, head[p]);
+			}
+		}
+	}
+}
+
+
+vector<unordered_map<int, double>> GraphAlgorithms::ch_costs_to_targets(
+	const ContractionHierarchy& ch,
+	const vector<vector<int>>& list_o,
+	const vector<int>& targets,
+	double cut_off,
+	const string& weight_name,
+	int num_thread)
+{
+	const int n = static_cast<int>(ch.rank.size());
+	int field = edge_attr.find(weight_name); // 形心边权重直接读属性列
+
+	// 去重后的目标
+	vector<int> unique_targets;
+	{
+		SearchWorkspace& ws = SearchWorkspace::local(0);
+		ws.reset(n);
+		ws.mark_targets(targets);
+		for (int t : targets) {
+			if (t != -1 && ws.settle_target(t)) unique_targets.push_back(t);
+		}
+	}
+	const size_t num_targets = unique_targets.size();
+
+	// 反向：各目标沿向下弧向上搜索，记录 (节点, 花费)
+	vector<vector<pair<int, cost_t>>> spaces(num_targets);
+	parallel_parts(num_targets, thread_parts(num_targets, num_thread), [&](size_t, size_t begin, size_t end) {
+		for (size_t k = begin; k < end; ++k) {
+			upward_search(ch.down_offset, ch.down_source, ch.down_weight, { { unique_targets[k], 0.0 } }, cut_off, n,
+				[&](int u, cost_t d) { spaces[k].emplace_back(u, d); });
+		}
+	});
+
+	// 按节点汇总为桶：bucket_offset[u]..bucket_offset[u + 1] 为经过 u 的 (目标序号, 花费)
+	vector<int> bucket_offset(n + 1, 0);
+	for (const auto& space : spaces) {
+		for (const auto& item : space) ++bucket_offset[item.first + 1];
+	}
+	for (int u = 0; u < n; ++u) bucket_offset[u + 1] += bucket_offset[u];
+	vector<pair<int, cost_t>> buckets(bucket_offset[n]);
+	{
+		vector<int> fill(bucket_offset.begin(), bucket_offset.end() - 1);
+		for (size_t k = 0; k < num_targets; ++k) {
+			for (const auto& item : spaces[k]) {
+				buckets[fill[item.first]++] = { static_cast<int>(k), item.second };
+			}
+		}
+	}
+	spaces.clear();
+	spaces.shrink_to_fit();
+
+	// 正向：各组源点沿向上弧搜索，扫描途经节点的桶取最小和
+	vector<unordered_map<int, double>> costs(list_o.size());
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		vector<cost_t> best(num_targets, numeric_limits<cost_t>::infinity());
+		vector<int> touched;
+		vector<pair<int, cost_t>> seeds;
+		for (size_t i = begin; i < end; ++i) {
+			if (list_o[i].empty()) continue;
+
+			// 形心点在快照中没有出边，直接从其出边终点开始
+			seeds.clear();
+			for (int s : list_o[i]) {
+				seeds.emplace_back(s, 0.0);
+				if (!is_centroid(s)) continue;
+				auto start_it = m_centroid_start_map.find(s);
+				if (start_it == m_centroid_start_map.end()) continue;
+				for (const auto& edge : start_it->second) {
+					if (is_centroid(edge.first)) continue;
+					seeds.emplace_back(edge.first, get_edge_weight(edge.second, field));
+				}
+			}
+
+			upward_search(ch.up_offset, ch.up_target, ch.up_weight, seeds, cut_off, n, [&](int u, cost_t d) {
+				for (int p = bucket_offset[u]; p < bucket_offset[u + 1]; ++p) {
+					const auto& entry = buckets[p];
+					const cost_t total = d + entry.second;
+					if (total < best[entry.first]) {
+						if (best[entry.first] == numeric_limits<cost_t>::infinity()) touched.push_back(entry.first);
+						best[entry.first] = total;
+					}
+				}
+			});
+
+			for (int k : touched) {
+				if (best[k] <= cut_off) costs[i][node_ids[unique_targets[k]]] = best[k];
+				best[k] = numeric_limits<cost_t>::infinity();
+			}
+			touched.clear();
+		}
+	});
+	return costs;
+}
+
+
+// PHAST 每次扫描同时处理的源点数：花费按 (收缩次序, 源点) 连续存放，扫描内层循环可向量化
+static const int PHAST_BATCH = 8;
+
+vector<unordered_map<int, double>> GraphAlgorithms::phast_costs(
+	const ContractionHierarchy& ch,
+	const vector<int>& sources,
+	double cut_off,
+	const string& weight_name,
+	int num_thread)
+{
+	const int n = static_cast<int>(ch.rank.size());
+	const cost_t inf = numeric_limits<cost_t>::infinity();
+	int field = edge_attr.find(weight_name); // 形心边权重直接读属性列
+	const size_t num_batches = (sources.size() + PHAST_BATCH - 1) / PHAST_BATCH;
+	vector<unordered_map<int, double>> costs(sources.size());
+
+	parallel_parts(num_batches, thread_parts(num_batches, num_thread), [&](size_t, size_t begin, size_t end) {
+		vector<cost_t> dist(static_cast<size_t>(n) * PHAST_BATCH);
+		vector<pair<int, cost_t>> seeds;
+		for (size_t batch = begin; batch < end; ++batch) {
+			const size_t first = batch * PHAST_BATCH;
+			const size_t count = min<size_t>(PHAST_BATCH, sources.size() - first);
+			fill(dist.begin(), dist.end(), inf);
+
+			// 1.各源点沿向上弧搜索（形心点在快照中没有出边，直接从其出边终点开始）
+			for (size_t k = 0; k < count; ++k) {
+				const int s = sources[first + k];
+				if (s == -1) continue;
+				seeds.assign(1, { s, 0.0 });
+				auto start_it = is_centroid(s) ? m_centroid_start_map.find(s) : m_centroid_start_map.end();
+				if (start_it != m_centroid_start_map.end()) {
+					for (const auto& edge : start_it->second) {
+						if (is_centroid(edge.first)) continue;
+						seeds.emplace_back(edge.first, get_edge_weight(edge.second, field));
+					}
+				}
+				upward_search(ch.up_offset, ch.up_target, ch.up_weight, seeds, cut_off, n,
+					[&](int u, cost_t d) { dist[static_cast<size_t>(ch.rank[u]) * PHAST_BATCH + k] = d; });
+			}
+
+			// 2.按收缩次序从高到低扫描向下弧，弧的上端已是最终花费
+			for (int r = n - 1; r >= 0; --r) {
+				cost_t* to = dist.data() + static_cast<size_t>(r) * PHAST_BATCH;
+				for (int p = ch.sweep_offset[r]; p < ch.sweep_offset[r + 1]; ++p) {
+					const cost_t* from = dist.data() + static_cast<size_t>(ch.sweep_source[p]) * PHAST_BATCH;
+					const cost_t w = ch.sweep_weight[p];
+					for (int k = 0; k < PHAST_BATCH; ++k) {
+						to[k] = min(to[k], from[k] + w);
+					}
+				}
+			}
 
-	return vector<vector<int>>(listA.begin(), listA.begin() + min(static_cast<size_t>(K), listA.size()));
+			// 3.输出 cut_off 内的节点
+			for (size_t k = 0; k < count; ++k) {
+				auto within = [&](int r) {
+					const cost_t d = dist[static_cast<size_t>(r) * PHAST_BATCH + k];
+					return d < inf && d <= cut_off;
+				};
+				size_t num_reached = 0;
+				for (int r = 0; r < n; ++r) num_reached += within(r);
+				auto& cost = costs[first + k];
+				cost.reserve(num_reached);
+				for (int r = 0; r < n; ++r) {
+					if (within(r)) cost[node_ids[ch.order[r]]] = dist[static_cast<size_t>(r) * PHAST_BATCH + k];
+				}
+			}
+		}
+	});
+	return costs;
 }
 
 
-// 获取单个OD对的花费
-pair<double, vector<int>> GraphAlgorithms::single_source_to_target(
-	int source,
-	int target,
-	const string& weight_name) 
+vector<unordered_map<int, double>> GraphAlgorithms::crp_costs_to_targets(
+	const MultilevelOverlay& ov,
+	const OverlayMetric& metric,
+	const vector<vector<int>>& list_o,
+	const vector<int>& targets,
+	double cut_off,
+	int weight_index,
+	const string& weight_name,
+	int num_thread)
 {
-	// 1.节点检查
-	if (G.find(source) == G.end()) {
-		throw std::runtime_error("source node not in graph");
-	}
-	if (G.find(target) == G.end()) {
-		throw std::runtime_error("target node not in graph");
-	}
-
-	// 2.权重获取
-	const auto& weight_map = get_weight_map(weight_name);
-	const auto& reverse_weight_map = get_weight_reverse_map(weight_name);
+	const CSRGraph& g = csr;
+	int field = edge_attr.find(weight_name); // 形心边权重直接读属性列
+	vector<unordered_map<int, double>> costs(list_o.size());
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		SearchWorkspace& ws = SearchWorkspace::local(0);
+		vector<pair<int, cost_t>> seeds;
+		for (size_t i = begin; i < end; ++i) {
+			if (list_o[i].empty()) continue;
+
+			// 形心点在快照中没有出边，直接从其出边终点开始
+			int source = list_o[i].front();
+			seeds.assign(1, { source, 0.0 });
+			auto start_it = is_centroid(source) ? m_centroid_start_map.find(source) : m_centroid_start_map.end();
+			if (start_it != m_centroid_start_map.end()) {
+				for (const auto& edge : start_it->second) {
+					if (is_centroid(edge.first)) continue;
+					seeds.emplace_back(edge.first, get_edge_weight(edge.second, field));
+				}
+			}
+			OverlayLevels levels(ov, seeds, targets);
+			overlay_search(g, weight_index, ov, metric, levels, seeds, targets, cut_off, ws);
+			// 目标均在原图层上确定，花费为最终值
+			for (int t : targets) {
+				if (t != -1 && ws.reached(t) && ws.dist[t] <= cut_off) {
+					costs[i][node_ids[t]] = ws.dist[t];
+				}
+			}
+		}
+	});
+	return costs;
+}
 
-	// 3.设置初始参数
-	set<int> ignore_nodes;
-	set<pair<int, int>> ignore_edges;
-	double cut_off = numeric_limits<double>::infinity();
-
-	// 双向Dijkstra计算最短路径 
-	auto result = bidirectional_dijkstra_ignore(
-		reverse_weight_map,
-		weight_map,
-		{ source },
-		target,
-		cut_off,
-		ignore_nodes,
-		ignore_edges);
-
-	if (result.cost.find(target) != result.cost.end() && result.cost[target] < numeric_limits<double>::infinity()) {
-		double length = result.cost[target];
-		vector<int> spur = result.paths[target];
-		return {length, spur};
-	}
-	else {
-		cout << "not find target path" << endl;
-		double length = -1;
-		vector<int> spur;
-		spur.push_back(source);
-		return { length, spur };
-	}
 
-}
 
 // 调用方法 ---------------------------------------------------------------------------------------
 
@@ -1098,16 +4369,18 @@ unordered_map<int, double> GraphAlgorithms::multi_source_cost(
 	const py::object& cut_off_,
 	const py::object& weight_name_)
 {
-	auto list_o = list_o_.cast<vector<int>>();
+	auto list_o = find_nodes(list_o_.cast<vector<int>>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<std::string>();
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 	// 逻辑执行
-	if (method == "Dijkstra") {
-		unordered_map<int, double> result = multi_source_dijkstra_cost(weight_map, list_o, target, cut_off, weight_name);
+	if (queue != QueueKind::None) {
+		unordered_map<int, double> result = cost_to_map(multi_source_dijkstra_cost(g, weight_index, list_o, target, cut_off, queue));
 		return result;
 	}
 }
@@ -1121,17 +4394,23 @@ unordered_map<int, vector<int>> GraphAlgorithms::multi_source_path(
 	const py::object& weight_name_)
 {
 	
-	auto list_o = list_o_.cast<vector<int>>();
+	auto list_o = find_nodes(list_o_.cast<vector<int>>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	vector<int> endpoints = list_o;
+	endpoints.push_back(target);
+	const CSRGraph& g = route_graph(endpoints, weight_name, weight_index);
 	// 逻辑执行
-	if (method == "Dijkstra") {
+	if (queue != QueueKind::None) {
 		// 逻辑执行
-		unordered_map<int, vector<int>> result = multi_source_dijkstra_path(weight_map, list_o, target, cut_off, weight_name);
+		SearchResult search = multi_source_dijkstra(g, weight_index, list_o, target, cut_off, queue);
+		if (&g != &csr) expand_result(search, weight_index, cut_off);
+		unordered_map<int, vector<int>> result = path_to_map(search);
 		return result;
 	}
 }
@@ -1144,16 +4423,18 @@ dis_and_path GraphAlgorithms::multi_source_all(
 	const py::object& cut_off_,
 	const py::object& weight_name_)
 {
-	auto list_o = list_o_.cast<vector<int>>();
+	auto list_o = find_nodes(list_o_.cast<vector<int>>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 	// 逻辑执行
-	if (method == "Dijkstra") {
-		dis_and_path result = multi_source_dijkstra(weight_map, list_o, target, cut_off, weight_name);
+	if (queue != QueueKind::None) {
+		dis_and_path result = all_to_map(multi_source_dijkstra(g, weight_index, list_o, target, cut_off, queue));
 		return result;
 	}
 }
@@ -1167,20 +4448,22 @@ unordered_map<int, double> GraphAlgorithms::single_source_cost(
 	const py::object& cut_off_,
 	const py::object& weight_name_)
 {
-	auto o = o_.cast<int>();
+	auto o = find_node(o_.cast<int>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	vector<int> list_o;
-	list_o.push_back(o);
+	if (o != -1) list_o.push_back(o);
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 
 	// 逻辑执行
-	if (method == "Dijkstra") {
+	if (queue != QueueKind::None) {
 		unordered_map<int, double> result;
-		result = multi_source_dijkstra_cost(weight_map,list_o, target, cut_off, weight_name);
+		result = cost_to_map(multi_source_dijkstra_cost(g, weight_index, list_o, target, cut_off, queue));
 		return result;
 	}
 }
@@ -1193,18 +4476,20 @@ unordered_map<int, std::vector<int>> GraphAlgorithms::single_source_path(
 	const py::object& cut_off_,
 	const py::object& weight_name_)
 {
-	auto o = o_.cast<int>();
+	auto o = find_node(o_.cast<int>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	vector<int> list_o;
-	list_o.push_back(o);
+	if (o != -1) list_o.push_back(o);
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 	// 逻辑执行
-	if (method == "Dijkstra") {
-		unordered_map<int, vector<int>> result = multi_source_dijkstra_path(weight_map, list_o, target, cut_off, weight_name);
+	if (queue != QueueKind::None) {
+		unordered_map<int, vector<int>> result = path_to_map(multi_source_dijkstra(g, weight_index, list_o, target, cut_off, queue));
 		return result;
 	}
 }
@@ -1217,18 +4502,20 @@ dis_and_path GraphAlgorithms::single_source_all(
 	const py::object& cut_off_,
 	const py::object& weight_name_)
 {
-	auto o = o_.cast<int>();
+	auto o = find_node(o_.cast<int>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	vector<int> list_o;
-	list_o.push_back(o);
+	if (o != -1) list_o.push_back(o);
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 	// 逻辑执行
-	if (method == "Dijkstra") {
-		dis_and_path result = multi_source_dijkstra(weight_map, list_o, target, cut_off, weight_name);
+	if (queue != QueueKind::None) {
+		dis_and_path result = all_to_map(multi_source_dijkstra(g, weight_index, list_o, target, cut_off, queue));
 		return result;
 	}
 }
@@ -1242,57 +4529,37 @@ vector<unordered_map<int, double>> GraphAlgorithms::multi_single_source_cost(
 	const py::object& cut_off_,
 	const py::object& weight_name_,
 	const py::object& num_thread_) {
-	auto list_o = list_o_.cast<vector<int>>();
+	// 不在图中的起点记为 -1，对应空结果，保持与输入对齐
+	auto starts = list_o_.cast<vector<int>>();
+	vector<int> list_o(starts.size());
+	for (size_t i = 0; i < starts.size(); ++i) list_o[i] = find_node(starts[i]);
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	auto num_thread = num_thread_.cast<int>();
 
-	const auto& weight_map = get_weight_map(weight_name);
-	// 逻辑执行
-	vector<unordered_map<int, double>> final_result(list_o.size());  // 初始化结果容器，大小为 list_o.size()
-	final_result.reserve(list_o.size());
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
-
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list.push_back(list_o[i]);
-					unordered_map<int, double> result;
-
-					// 使用给定的方法计算路径
-					if (method == "Dijkstra") {
-						result = multi_source_dijkstra_cost(weight_map, cur_list, target, cut_off, weight_name);
-
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保结果顺序正确
-					}
-				}
-			}));
-		}
-
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
-		}
-		threads.clear();
+	if (method == "PHAST") {
+		// 收缩层次上的一到全部扫描：总是求完整最短路树，target 不用于提前终止
+		const ContractionHierarchy& ch = get_ch(weight_name);
+		py::gil_scoped_release release;
+		return phast_costs(ch, list_o, cut_off, weight_name, num_thread);
 	}
 
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<unordered_map<int, double>> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (list_o[i] == -1) continue;
+			final_result[i] = cost_to_map(multi_source_dijkstra_cost(g, weight_index, { list_o[i] }, target, cut_off, queue));
+		}
+	});
 	return final_result;
 }
 
@@ -1304,53 +4571,30 @@ vector<unordered_map<int, vector<int>>> GraphAlgorithms::multi_single_source_pat
 	const py::object& cut_off_,
 	const py::object& weight_name_,
 	const py::object& num_thread_) {
-	auto list_o = list_o_.cast<vector<int>>();
+	// 不在图中的起点记为 -1，对应空结果，保持与输入对齐
+	auto starts = list_o_.cast<vector<int>>();
+	vector<int> list_o(starts.size());
+	for (size_t i = 0; i < starts.size(); ++i) list_o[i] = find_node(starts[i]);
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	auto num_thread = num_thread_.cast<int>();
 
-	const auto& weight_map = get_weight_map(weight_name);
-	// 逻辑执行
-	vector<unordered_map<int, vector<int>>> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
-
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list.push_back(list_o[i]);
-					if (method == "Dijkstra") {
-						unordered_map<int, vector<int>> result = multi_source_dijkstra_path(weight_map, cur_list, target, cut_off, weight_name);
-
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保将结果存储在正确的索引位置
-					}
-				}
-			}));
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<unordered_map<int, vector<int>>> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (list_o[i] == -1) continue;
+			final_result[i] = path_to_map(multi_source_dijkstra(g, weight_index, { list_o[i] }, target, cut_off, queue));
 		}
-
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
-		}
-		threads.clear();
-	}
-
+	});
 	return final_result;
 }
 
@@ -1363,55 +4607,30 @@ vector<dis_and_path> GraphAlgorithms::multi_single_source_all(
 	const py::object& weight_name_,
 	const py::object& num_thread_)
 {
-	auto list_o = list_o_.cast<vector<int>>();
+	// 不在图中的起点记为 -1，对应空结果，保持与输入对齐
+	auto starts = list_o_.cast<vector<int>>();
+	vector<int> list_o(starts.size());
+	for (size_t i = 0; i < starts.size(); ++i) list_o[i] = find_node(starts[i]);
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	auto num_thread = num_thread_.cast<int>();
 
-	const auto& weight_map = get_weight_map(weight_name);
-	// 逻辑执行
-	vector<dis_and_path> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
-
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list.push_back(list_o[i]);
-
-					// 执行 Dijkstra 或其他算法
-					if (method == "Dijkstra") {
-						dis_and_path result = multi_source_dijkstra(weight_map, cur_list, target, cut_off, weight_name);
-
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保将结果存储在正确的索引位置
-					}
-				}
-			}));
-		}
-
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<dis_and_path> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			if (list_o[i] == -1) continue;
+			final_result[i] = all_to_map(multi_source_dijkstra(g, weight_index, { list_o[i] }, target, cut_off, queue));
 		}
-		threads.clear();
-	}
-
+	});
 	return final_result;
 }
 
@@ -1426,115 +4645,63 @@ vector<unordered_map<int, double>> GraphAlgorithms::multi_multi_source_cost(
 	const py::object& num_thread_)
 {
 	auto list_o = list_o_.cast<vector<vector<int>>>();
+	for (auto& sources : list_o) sources = find_nodes(sources);
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
-	auto cut_off = cut_off_.cast<double>();
-	auto weight_name = weight_name_.cast<string>();
-	auto num_thread = num_thread_.cast<int>();
-
-	const auto& weight_map = get_weight_map(weight_name);
-	// 逻辑执行
-	vector<unordered_map<int, double>> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
-
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list = list_o[i];
-
-					// 执行 Dijkstra 或其他算法
-					if (method == "Dijkstra") {
-						unordered_map<int, double> result = multi_source_dijkstra_cost(weight_map, cur_list, target, cut_off, weight_name);
-
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保将结果存储在正确的索引位置
-					}
-				}
-			}));
-		}
-
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
-		}
-		threads.clear();
-	}
-
-	return final_result;
-}
-
-
-vector<unordered_map<int, vector<int>>> GraphAlgorithms::multi_multi_source_path(
-	const py::object& list_o_,
-	const py::object& method_,
-	const py::object& target_,
-	const py::object& cut_off_,
-	const py::object& weight_name_,
-	const py::object& num_thread_)
-{	
-	auto list_o = list_o_.cast<vector<vector<int>>>();
-	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	auto num_thread = num_thread_.cast<int>();
 
-	const auto& weight_map = get_weight_map(weight_name);
-	// 逻辑执行
-	vector<unordered_map<int, vector<int>>> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
-
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list = list_o[i];
-
-					// 执行 Dijkstra 或其他算法
-					if (method == "Dijkstra") {
-						unordered_map<int, vector<int>> result = multi_source_dijkstra_path(weight_map, cur_list, target, cut_off, weight_name);
-
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保将结果存储在正确的索引位置
-					}
-				}
-			}));
-		}
-
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<unordered_map<int, double>> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			final_result[i] = cost_to_map(multi_source_dijkstra_cost(g, weight_index, list_o[i], target, cut_off, queue));
 		}
-		threads.clear();
-	}
+	});
+	return final_result;
+}
+
+
+vector<unordered_map<int, vector<int>>> GraphAlgorithms::multi_multi_source_path(
+	const py::object& list_o_,
+	const py::object& method_,
+	const py::object& target_,
+	const py::object& cut_off_,
+	const py::object& weight_name_,
+	const py::object& num_thread_)
+{	
+	auto list_o = list_o_.cast<vector<vector<int>>>();
+	for (auto& sources : list_o) sources = find_nodes(sources);
+	auto method = method_.cast<string>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
+	auto cut_off = cut_off_.cast<double>();
+	auto weight_name = weight_name_.cast<string>();
+	auto num_thread = num_thread_.cast<int>();
 
+	int weight_index = get_weight_index(weight_name);
+	vector<int> endpoints{ target };
+	for (const auto& sources : list_o) endpoints.insert(endpoints.end(), sources.begin(), sources.end());
+	const CSRGraph& g = route_graph(endpoints, weight_name, weight_index);
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<unordered_map<int, vector<int>>> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			SearchResult search = multi_source_dijkstra(g, weight_index, list_o[i], target, cut_off, queue);
+			if (&g != &csr) expand_result(search, weight_index, cut_off);
+			final_result[i] = path_to_map(search);
+		}
+	});
 	return final_result;
 }
 
@@ -1548,60 +4715,94 @@ vector<dis_and_path> GraphAlgorithms::multi_multi_source_all(
 	const py::object& num_thread_)
 {
 	auto list_o = list_o_.cast<vector<vector<int>>>();
+	for (auto& sources : list_o) sources = find_nodes(sources);
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	auto num_thread = num_thread_.cast<int>();
 
-	const auto& weight_map = get_weight_map(weight_name);
-	// 逻辑执行
-	vector<dis_and_path> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<dis_and_path> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			final_result[i] = all_to_map(multi_source_dijkstra(g, weight_index, list_o[i], target, cut_off, queue));
+		}
+	});
+	return final_result;
+}
 
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list = list_o[i];
 
-					// 执行 Dijkstra 或其他算法
-					if (method == "Dijkstra") {
-						dis_and_path result = multi_source_dijkstra(weight_map, cur_list, target, cut_off, weight_name);
+// 多个单源到目标集的花费
+vector<unordered_map<int, double>> GraphAlgorithms::multi_single_source_cost_targets(
+	const py::object& list_o_,
+	const py::object& targets_,
+	const py::object& method_,
+	const py::object& cut_off_,
+	const py::object& weight_name_,
+	const py::object& num_thread_)
+{
+	auto starts = list_o_.cast<vector<int>>();
+	auto targets = targets_.cast<vector<int>>();
+	auto method = method_.cast<string>();
+	QueueKind queue = dijkstra_queue(method);
+	auto cut_off = cut_off_.cast<double>();
+	auto weight_name = weight_name_.cast<string>();
+	auto num_thread = num_thread_.cast<int>();
 
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保将结果存储在正确的索引位置
-					}
-				}
-			}));
-		}
+	// 不在图中的起点对应空结果，保持与输入对齐
+	vector<vector<int>> list_o(starts.size());
+	for (size_t i = 0; i < starts.size(); ++i) {
+		int u = find_node(starts[i]);
+		if (u != -1) list_o[i].push_back(u);
+	}
+	for (auto& t : targets) t = find_node(t);
 
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
-		}
-		threads.clear();
+	if (method == "CRP") {
+		const OverlayMetric& metric = get_overlay_metric(weight_name);
+		int weight_index = get_weight_index(weight_name);
+		py::gil_scoped_release release;
+		return crp_costs_to_targets(overlay, metric, list_o, targets, cut_off, weight_index, weight_name, num_thread);
 	}
+	if (queue == QueueKind::None) return vector<unordered_map<int, double>>(list_o.size());
+	py::gil_scoped_release release;
+	return costs_to_targets(list_o, targets, cut_off, weight_name, num_thread, queue, false);
+}
 
-	return final_result;
+
+// 多个多源到目标集的花费
+vector<unordered_map<int, double>> GraphAlgorithms::multi_multi_source_cost_targets(
+	const py::object& list_o_,
+	const py::object& targets_,
+	const py::object& method_,
+	const py::object& cut_off_,
+	const py::object& weight_name_,
+	const py::object& num_thread_)
+{
+	auto list_o = list_o_.cast<vector<vector<int>>>();
+	for (auto& sources : list_o) sources = find_nodes(sources);
+	auto targets = targets_.cast<vector<int>>();
+	for (auto& t : targets) t = find_node(t);
+	auto method = method_.cast<string>();
+	QueueKind queue = dijkstra_queue(method);
+	auto cut_off = cut_off_.cast<double>();
+	auto weight_name = weight_name_.cast<string>();
+	auto num_thread = num_thread_.cast<int>();
+
+	if (queue == QueueKind::None) return vector<unordered_map<int, double>>(list_o.size());
+	py::gil_scoped_release release;
+	return costs_to_targets(list_o, targets, cut_off, weight_name, num_thread, queue, false);
 }
 
 
 // 花费矩阵
-py::array_t<double>  GraphAlgorithms::cost_matrix_to_numpy(
+py::array_t<cost_t>  GraphAlgorithms::cost_matrix_to_numpy(
 	const py::object& starts_,
 	const py::object& ends_,
 	const py::object& method_,
@@ -1609,99 +4810,104 @@ py::array_t<double>  GraphAlgorithms::cost_matrix_to_numpy(
 	const py::object& weight_name_,
 	const py::object& num_thread_)
 {	
-	// 逻辑运行
-	GTemp = G;
 	// 获取起点列表和终点列表及其大小
 	auto starts = starts_.cast<vector<int>>();
 	auto ends = ends_.cast<vector<int>>();
 	auto weight_name = weight_name_.cast<string>();
+	int field = edge_attr.find(weight_name);
 	auto num_thread = num_thread_.cast<int>();
+	if (num_thread < 1) num_thread = 1;
 	size_t num_starts = starts.size();
 	size_t num_ends = ends.size();
 
-	// 将行星点加入临时图
-	for (auto i : starts) {
-		if (m_node_map[i]["centroid_"] == 1) {
-			GTemp[i] = m_centroid_start_map[i];
-		}
-	}
-
-	// 创建一个二维数组来存储所有起点到终点的花费
-	py::array_t<double> result({ num_starts, num_ends });
+	// 创建一个二维数组来存储所有起点到终点的花费（紧凑模式下为 float32）
+	py::array_t<cost_t> result({ num_starts, num_ends });
 	py::buffer_info buf_info = result.request();
-	double* ptr = static_cast<double*>(buf_info.ptr);
-
-	py::object target_ = py::int_(-1);
-	vector<vector<int>> multi_list_;
-
-	// 这里根据num_thread来分批处理
-	size_t num_batches = (num_starts + num_thread - 1) / num_thread;  // 计算批次数
-
-	// 循环每个批次
-	for (size_t batch_idx = 0; batch_idx < num_batches; ++batch_idx) {
-		// 计算当前批次的起点范围
-		size_t start_idx = batch_idx * num_thread;
-		size_t end_idx = min((batch_idx + 1) * num_thread, num_starts);
-
-		// 生成当前批次的multi_list_
-		multi_list_.clear();
-		for (size_t i = start_idx; i < end_idx; ++i) {
-			vector<int> cur_vec{ starts[i] };
-			multi_list_.push_back(cur_vec);
+	cost_t* ptr = static_cast<cost_t*>(buf_info.ptr);
+
+	// 目标集：非形心终点，以及形心终点的各前导节点
+	vector<int> targets;
+	for (int end : ends) {
+		int u = find_node(end);
+		if (u == -1) continue;
+		if (!is_centroid(u)) {
+			targets.push_back(u);
+			continue;
+		}
+		auto end_it = m_centroid_end_map.find(u);
+		if (end_it == m_centroid_end_map.end()) continue;
+		for (const auto& pair : end_it->second) {
+			targets.push_back(pair.first);
 		}
+	}
 
-		// 转换成 py::object（已经是 py::list 类型）
-		py::object multi_list_obj = py::cast(multi_list_);
+	// 每个起点搜索至目标集全部确定
+	vector<vector<int>> list_o(num_starts);
+	for (size_t i = 0; i < num_starts; ++i) {
+		int u = find_node(starts[i]);
+		if (u != -1) list_o[i].push_back(u);
+	}
+	auto method = method_.cast<string>();
+	QueueKind queue = dijkstra_queue(method);
+	auto cut_off = cut_off_.cast<double>();
+	vector<unordered_map<int, double>> multi_result(num_starts);
+	if (method == "CH") {
+		// 收缩层次上的多对多桶算法
+		const ContractionHierarchy& ch = get_ch(weight_name);
+		py::gil_scoped_release release;
+		multi_result = ch_costs_to_targets(ch, list_o, targets, cut_off, weight_name, num_thread);
+	}
+	else if (queue != QueueKind::None) {
+		py::gil_scoped_release release;
+		multi_result = costs_to_targets(list_o, targets, cut_off, weight_name, num_thread, queue, true);
+	}
 
-		// 计算当前批次的多源最短路径
-		vector<unordered_map<int, double>> multi_result = multi_multi_source_cost_centroid(multi_list_obj, method_, target_, cut_off_, weight_name_, num_thread_);
+	// 填充 cost matrix
+	for (size_t i = 0; i < num_starts; ++i) {
+		for (size_t j = 0; j < num_ends; ++j) {
+			// 如果起点等于终点，直接返回0
+			if (starts[i] == ends[j]) {
+				ptr[i * num_ends + j] = 0;
+				continue; 
+			}
 
-		// 填充当前批次的 cost matrix
-		for (size_t i = start_idx; i < end_idx; ++i) {
-			for (size_t j = 0; j < num_ends; ++j) {
-				// 如果起点等于终点，直接返回0
-				if (starts[i] == ends[j]) {
-					ptr[i * num_ends + j] = 0;
-					continue; 
+			// 如果终点不是行星点
+			int end_index = find_node(ends[j]);
+			if (end_index == -1 || !is_centroid(end_index)) {
+				auto it = multi_result[i].find(ends[j]);
+				if (it != multi_result[i].end()) {
+					ptr[i * num_ends + j] = it->second;
 				}
-
-				// 如果终点是行星点
-				if (m_node_map[ends[j]]["centroid_"] != 1) {
-					auto it = multi_result[i - start_idx].find(ends[j]);
-					if (it != multi_result[i - start_idx].end()) {
-						ptr[i * num_ends + j] = it->second;
-					}
-					else {
-						ptr[i * num_ends + j] = -1; // 默认值
-					}
+				else {
+					ptr[i * num_ends + j] = -1; // 默认值
 				}
+			}
 
-				// 如果终点不是行星点
+			// 如果终点是行星点
+			else {
+				auto end_it = m_centroid_end_map.find(end_index);
+				if (end_it == m_centroid_end_map.end() || end_it->second.size() == 0) {
+					ptr[i * num_ends + j] = -1;
+				}
 				else {
-					if (m_centroid_end_map[ends[j]].size() == 0) {
-						ptr[i * num_ends + j] = -1;
-					}
-					else {
-						double minest_cost = numeric_limits<double>::infinity();
-						// 遍历前导图
-						for (const auto& pair : m_centroid_end_map[ends[j]]) {
-							// 1. 判断 pair.second[weight_name] 是否存在
-							const auto& weight_it = pair.second.find(weight_name);
-							const double weight_value = (weight_it != pair.second.end()) ? weight_it->second : 1.0;
-
-							// 2. 判断 multi_result[i][pair.first] 是否存在
-							const auto& result_it = multi_result[i - start_idx].find(pair.first);
-							if (result_it == multi_result[i - start_idx].end()) {
-								continue; // 跳过本次循环
-							}
-
-							// 3. 计算当前成本
-							const double cur_cost = weight_value + result_it->second;
-							minest_cost = std::min(minest_cost, cur_cost);
+					double minest_cost = numeric_limits<double>::infinity();
+					// 遍历前导图
+					for (const auto& pair : end_it->second) {
+						// 1. 判断 pair.second[weight_name] 是否存在
+						const double weight_value = get_edge_weight(pair.second, field);
+
+						// 2. 判断 multi_result[i][pair.first] 是否存在
+						const auto& result_it = multi_result[i].find(node_ids[pair.first]);
+						if (result_it == multi_result[i].end()) {
+							continue; // 跳过本次循环
 						}
-						// 最终赋值逻辑（需处理全跳过的边界情况）
-						ptr[i * num_ends + j] = (minest_cost != std::numeric_limits<double>::infinity()) ? minest_cost : -1;
+
+						// 3. 计算当前成本
+						const double cur_cost = weight_value + result_it->second;
+						minest_cost = std::min(minest_cost, cur_cost);
 					}
+					// 最终赋值逻辑（需处理全跳过的边界情况）
+					ptr[i * num_ends + j] = (minest_cost != std::numeric_limits<double>::infinity()) ? minest_cost : -1;
 				}
 			}
 		}
@@ -1720,48 +4926,30 @@ py::dict GraphAlgorithms::path_list_to_numpy(
 	const py::object& weight_name_,
 	const py::object& num_thread_)
 {
-	// 获取起点列表和终点列表的大小
+	// 获取起点列表和终点列表
 	auto starts = starts_.cast<vector<int>>();
 	auto ends = ends_.cast<vector<int>>();
-	size_t num_starts = starts.size();
-	size_t num_ends = ends.size();
+	auto method = method_.cast<string>();
+	QueueKind queue = dijkstra_queue(method);
+	auto cut_off = cut_off_.cast<double>();
+	auto weight_name = weight_name_.cast<string>();
+	auto num_thread = num_thread_.cast<int>();
 
-	// 创建一个字典来存储结果
-	py::dict result;
+	// 每个起点搜索一次，只回溯 ends 中的路径
+	vector<vector<vector<int>>> paths;
+	if (queue != QueueKind::None) {
+		py::gil_scoped_release release;
+		paths = paths_to_targets(starts, ends, cut_off, weight_name, num_thread, queue);
+	}
+	else {
+		paths.assign(starts.size(), vector<vector<int>>(ends.size()));
+	}
 
-	py::object target_ = py::int_(-1);
-	vector<vector<int>> multi_list_;
-	for (auto i : starts) {
-		vector<int> cur_vec{ i };
-		multi_list_.push_back(cur_vec);
-	}
-	py::object multi_list_obj = py::cast(multi_list_);
-
-	vector<unordered_map<int, vector<int>>> multi_result = multi_multi_source_path(multi_list_obj,
-		method_,
-		target_,
-		cut_off_,
-		weight_name_,
-		num_thread_);
-
-	// 填充字典
-	for (int i = 0; i < num_starts; ++i) {
-		for (int j = 0; j < num_ends; ++j) {
-			auto it = multi_result[i].find(ends[j]);
-			py::list path_list;
-
-			if (it != multi_result[i].end()) {
-				auto cur_path = it->second;
-				// 将 cur_path 的每个元素加入到 path_list 中，而不是将整个 cur_path 作为一个元素
-				for (const auto& node : cur_path) {
-					path_list.append(node);
-				}
-				result[py::make_tuple(starts[i], ends[j])] = path_list;  // 使用 (起点, 终点) 作为字典的键
-			}
-			else {
-				// 如果没有找到路径，使用空列表
-				result[py::make_tuple(starts[i], ends[j])] = py::list();
-			}
+	// 填充字典，(起点, 终点) 为键，未找到路径为空列表
+	py::dict result;
+	for (size_t i = 0; i < starts.size(); ++i) {
+		for (size_t j = 0; j < ends.size(); ++j) {
+			result[py::make_tuple(starts[i], ends[j])] = py::cast(paths[i][j]);
 		}
 	}
 
@@ -1779,53 +4967,26 @@ vector<unordered_map<int, double>> GraphAlgorithms::multi_multi_source_cost_cent
 	const py::object& num_thread_)
 {
 	auto list_o = list_o_.cast<vector<vector<int>>>();
+	for (auto& sources : list_o) sources = find_nodes(sources);
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	QueueKind queue = dijkstra_queue(method);
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
 	auto num_thread = num_thread_.cast<int>();
 
-	// 逻辑执行
-	vector<unordered_map<int, double>> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
-	vector<thread> threads;
-	atomic<size_t> index(0);
-	size_t max_threads = std::thread::hardware_concurrency();
-	if (num_thread >= max_threads) num_thread = max_threads - 1;
-
-	// 使用互斥锁来保护 final_result 的访问
-	std::mutex result_mutex;
-
-	while (index < list_o.size()) {
-		// 启动最大数量的线程
-		while (threads.size() < num_thread && index < list_o.size()) {
-			threads.push_back(thread([&]() {
-				size_t i = index++;  // 获取当前线程处理的节点索引
-				if (i < list_o.size()) {
-					// 每个线程处理一个节点
-					vector<int> cur_list;
-					cur_list = list_o[i];
-
-					// 执行 Dijkstra 或其他算法
-					if (method == "Dijkstra") {
-						unordered_map<int, double> result = multi_source_dijkstra_cost_centroid(cur_list, target, cut_off, weight_name);
-
-						// 使用互斥锁保护对 final_result 的访问
-						std::lock_guard<std::mutex> lock(result_mutex);
-						final_result[i] = result;  // 确保将结果存储在正确的索引位置
-					}
-				}
-			}));
-		}
-
-		// 等待线程池中的线程完成
-		for (auto& t : threads) {
-			if (t.joinable()) {
-				t.join();
-			}
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
+	// 逻辑执行：按起点分段并行，每个线程在自己的段内复用同一搜索工作区
+	vector<unordered_map<int, double>> final_result(list_o.size());
+	if (queue == QueueKind::None) return final_result;
+	py::gil_scoped_release release;
+	size_t num_parts = thread_parts(list_o.size(), num_thread);
+	parallel_parts(list_o.size(), num_parts, [&](size_t, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			final_result[i] = cost_to_map(multi_source_dijkstra_cost_centroid(g, weight_index, list_o[i], target, cut_off, weight_name, queue));
 		}
-		threads.clear();
-	}
-
+	});
 	return final_result;
 }
 
@@ -1835,14 +4996,16 @@ vector<vector<int>> GraphAlgorithms::k_shortest_paths(
 	const py::object& source_,
 	const py::object& target_,
 	const py::object& num_k_,
-	const py::object& weight_name_)
+	const py::object& weight_name_,
+	const py::object& method_)
 {
 	auto source = source_.cast<int>();
 	auto target = target_.cast<int>();
 	auto num_k = num_k_.cast<int>();
 	auto weight_name = weight_name_.cast<string>();
+	auto method = method_.cast<string>();
 
-	return(shortest_simple_paths_few(source, target, num_k, weight_name));
+	return(shortest_simple_paths_few(source, target, num_k, weight_name, method));
 }
 
 
@@ -1850,13 +5013,17 @@ vector<vector<int>> GraphAlgorithms::k_shortest_paths(
 double GraphAlgorithms::shortest_path_cost(
 	const py::object& source_,
 	const py::object& target_,
-	const py::object& weight_name_) 
+	const py::object& weight_name_,
+	const py::object& method_,
+	const py::object& max_speed_) 
 {
 	auto source = source_.cast<int>();
 	auto target = target_.cast<int>();
 	auto weight_name = weight_name_.cast<string>();
+	auto method = method_.cast<string>();
+	auto max_speed = max_speed_.cast<double>();
 
-	auto result = single_source_to_target(source, target, weight_name);
+	auto result = single_source_to_target(source, target, weight_name, method, max_speed);
 	double cost = result.first;
 	return cost;
 }
@@ -1866,13 +5033,17 @@ double GraphAlgorithms::shortest_path_cost(
 vector<int> GraphAlgorithms::shortest_path_path(
 	const py::object& source_,
 	const py::object& target_,
-	const py::object& weight_name_)
+	const py::object& weight_name_,
+	const py::object& method_,
+	const py::object& max_speed_)
 {
 	auto source = source_.cast<int>();
 	auto target = target_.cast<int>();
 	auto weight_name = weight_name_.cast<string>();
+	auto method = method_.cast<string>();
+	auto max_speed = max_speed_.cast<double>();
 
-	auto result = single_source_to_target(source, target, weight_name);
+	auto result = single_source_to_target(source, target, weight_name, method, max_speed);
 	vector<int> path = result.second;
 	return path;
 }
@@ -1882,13 +5053,17 @@ vector<int> GraphAlgorithms::shortest_path_path(
 pair<double, vector<int>> GraphAlgorithms::shortest_path_all(
 	const py::object& source_,
 	const py::object& target_,
-	const py::object& weight_name_) 
+	const py::object& weight_name_,
+	const py::object& method_,
+	const py::object& max_speed_) 
 {
 	auto source = source_.cast<int>();
 	auto target = target_.cast<int>();
 	auto weight_name = weight_name_.cast<string>();
+	auto method = method_.cast<string>();
+	auto max_speed = max_speed_.cast<double>();
 
-	auto result = single_source_to_target(source, target, weight_name);
+	auto result = single_source_to_target(source, target, weight_name, method, max_speed);
 	return result;
 }
 // test -------------------------------------------------------------------------------------------
@@ -1945,27 +5120,23 @@ vector<unordered_map<int, double>> GraphAlgorithms::test(
 	const py::object& weight_name_,
 	const py::object& num_thread_)
 {
-	auto list_o = list_o_.cast<vector<int>>();
+	auto list_o = find_nodes(list_o_.cast<vector<int>>());
 	auto method = method_.cast<string>();
-	auto target = target_.cast<int>();
+	auto target = find_node(target_.cast<int>());
 	auto cut_off = cut_off_.cast<double>();
 	auto weight_name = weight_name_.cast<string>();
+	int field = edge_attr.find(weight_name);
 	auto num_thread = num_thread_.cast<int>();
 
 	// 权重处理
 	auto start = chrono::steady_clock::now();
+	thaw();
 	G_temp.clear();
-	for (auto& entry : G) {
-		int u = entry.first;
-		auto& edges = entry.second;
+	for (int u = 0; u < static_cast<int>(G.size()); ++u) {
+		auto& edges = G[u];
 		for (auto& edge : edges) {
 			int v = edge.first;
-			auto& attrs = edge.second;
-			double weight = 1.0;
-			auto attr_it = attrs.find(weight_name);
-			if (attr_it != attrs.end()) {
-				weight = attr_it->second;
-			}
+			double weight = get_edge_weight(edge.second, field);
 
 			G_temp[u].emplace_back(v, weight);
 		}
@@ -1989,7 +5160,9 @@ vector<unordered_map<int, double>> GraphAlgorithms::test(
 			unordered_map<int, double> result;
 
 			if (method == "Dijkstra") {
-				result = test1(cur_list, target, cut_off, weight_name);
+				for (const auto& entry : test1(cur_list, target, cut_off, weight_name)) {
+					result[node_ids[entry.first]] = entry.second;
+				}
 			}
 
 			std::lock_guard<std::mutex> lock(result_mutex); // 锁保护结果
@@ -2095,10 +5268,10 @@ std::vector<py::array_t<double>> GraphAlgorithms::process_pairs(
 			"l",
 			10);
 
-		auto path_dict = path_list_to_numpy1(
+		// 路径只回溯 from_nodes_1 中的终点，直接按行列下标取用
+		vector<vector<vector<int>>> paths = paths_to_targets(
 			from_nodes_0,
 			from_nodes_1,
-			"Dijkstra",
 			numeric_limits<double>::infinity(),
 			"l",
 			10);
@@ -2121,18 +5294,10 @@ std::vector<py::array_t<double>> GraphAlgorithms::process_pairs(
 				}
 				// 条件2
 				else {
-					//auto key = std::make_pair(row0.from_node, row1.from_node);
-					auto key = py::make_tuple(row0.from_node, row1.from_node);  // 将 std::pair 转换为 py::tuple
-					if (path_dict.contains(key)) {  
-						const auto& path = path_dict[key].cast<std::vector<int>>();  // 将字典值转换为 std::vector<int>
-						//const auto& path = path_dict[key];
-						if (path.size() > 1 &&
-							path[1] == row0.to_node &&
-							(path[path.size() - 2] != row1.to_node)) {
-							cur_x = cost_matrix.at(idx0, idx1) - row0.route_dis + row1.route_dis;
-						}
-					}
-					else if (row0.from_node == row1.to_node && row0.to_node == row1.from_node) {
+					const auto& path = paths[idx0][idx1];
+					if (path.size() > 1 &&
+						path[1] == row0.to_node &&
+						(path[path.size() - 2] != row1.to_node)) {
 						cur_x = cost_matrix.at(idx0, idx1) - row0.route_dis + row1.route_dis;
 					}
 				}
@@ -2156,25 +5321,18 @@ py::array_t<double>  GraphAlgorithms::cost_matrix_to_numpy1(
 	const string& weight_name_,
 	const int& num_thread_)
 {
-	// 逻辑运行
-	GTemp = G;
 	// 获取起点列表和终点列表及其大小
 	auto starts = starts_;
 	auto ends = ends_;
 	auto method = method_;
 	auto cut_off = cut_off_;
 	auto weight_name = weight_name_;
+	int field = edge_attr.find(weight_name);
 	auto num_thread = num_thread_;
+	if (num_thread < 1) num_thread = 1;
 	size_t num_starts = starts.size();
 	size_t num_ends = ends.size();
 
-	// 将行星点加入临时图
-	for (auto i : starts) {
-		if (m_node_map[i]["centroid_"] == 1) {
-			GTemp[i] = m_centroid_start_map[i];
-		}
-	}
-
 	// 创建一个二维数组来存储所有起点到终点的花费
 	py::array_t<double> result({ num_starts, num_ends });
 	py::buffer_info buf_info = result.request();
@@ -2214,8 +5372,9 @@ py::array_t<double>  GraphAlgorithms::cost_matrix_to_numpy1(
 					continue;
 				}
 
-				// 如果终点是行星点
-				if (m_node_map[ends[j]]["centroid_"] != 1) {
+				// 如果终点不是行星点
+				int end_index = find_node(ends[j]);
+				if (end_index == -1 || !is_centroid(end_index)) {
 					auto it = multi_result[i - start_idx].find(ends[j]);
 					if (it != multi_result[i - start_idx].end()) {
 						ptr[i * num_ends + j] = it->second;
@@ -2225,21 +5384,21 @@ py::array_t<double>  GraphAlgorithms::cost_matrix_to_numpy1(
 					}
 				}
 
-				// 如果终点不是行星点
+				// 如果终点是行星点
 				else {
-					if (m_centroid_end_map[ends[j]].size() == 0) {
+					auto end_it = m_centroid_end_map.find(end_index);
+					if (end_it == m_centroid_end_map.end() || end_it->second.size() == 0) {
 						ptr[i * num_ends + j] = -1;
 					}
 					else {
 						double minest_cost = numeric_limits<double>::infinity();
 						// 遍历前导图
-						for (const auto& pair : m_centroid_end_map[ends[j]]) {
+						for (const auto& pair : end_it->second) {
 							// 1. 判断 pair.second[weight_name] 是否存在
-							const auto& weight_it = pair.second.find(weight_name);
-							const double weight_value = (weight_it != pair.second.end()) ? weight_it->second : 1.0;
+							const double weight_value = get_edge_weight(pair.second, field);
 
 							// 2. 判断 multi_result[i][pair.first] 是否存在
-							const auto& result_it = multi_result[i - start_idx].find(pair.first);
+							const auto& result_it = multi_result[i - start_idx].find(node_ids[pair.first]);
 							if (result_it == multi_result[i - start_idx].end()) {
 								continue; // 跳过本次循环
 							}
@@ -2269,48 +5428,20 @@ py::dict GraphAlgorithms::path_list_to_numpy1(
 	const string& weight_name_,
 	const int& num_thread_)
 {
-	// 获取起点列表和终点列表的大小
-	auto starts = starts_;
-	auto ends = ends_;
-	size_t num_starts = starts.size();
-	size_t num_ends = ends.size();
+	// 每个起点搜索一次，只回溯 ends 中的路径
+	vector<vector<vector<int>>> paths;
+	if (method_ == "Dijkstra") {
+		paths = paths_to_targets(starts_, ends_, cut_off_, weight_name_, num_thread_);
+	}
+	else {
+		paths.assign(starts_.size(), vector<vector<int>>(ends_.size()));
+	}
 
-	// 创建一个字典来存储结果
+	// 填充字典，(起点, 终点) 为键，未找到路径为空列表
 	py::dict result;
-
-	py::object target_ = py::int_(-1);
-	vector<vector<int>> multi_list_;
-	for (auto i : starts) {
-		vector<int> cur_vec{ i };
-		multi_list_.push_back(cur_vec);
-	}
-	py::object multi_list_obj = py::cast(multi_list_);
-
-	vector<unordered_map<int, vector<int>>> multi_result = multi_multi_source_path1(multi_list_,
-		method_,
-		-1,
-		cut_off_,
-		weight_name_,
-		num_thread_);
-
-	// 填充字典
-	for (int i = 0; i < num_starts; ++i) {
-		for (int j = 0; j < num_ends; ++j) {
-			auto it = multi_result[i].find(ends[j]);
-			py::list path_list;
-
-			if (it != multi_result[i].end()) {
-				auto cur_path = it->second;
-				// 将 cur_path 的每个元素加入到 path_list 中，而不是将整个 cur_path 作为一个元素
-				for (const auto& node : cur_path) {
-					path_list.append(node);
-				}
-				result[py::make_tuple(starts[i], ends[j])] = path_list;  // 使用 (起点, 终点) 作为字典的键
-			}
-			else {
-				// 如果没有找到路径，使用空列表
-				result[py::make_tuple(starts[i], ends[j])] = py::list();
-			}
+	for (size_t i = 0; i < starts_.size(); ++i) {
+		for (size_t j = 0; j < ends_.size(); ++j) {
+			result[py::make_tuple(starts_[i], ends_[j])] = py::cast(paths[i][j]);
 		}
 	}
 
@@ -2327,19 +5458,22 @@ vector<unordered_map<int, double>> GraphAlgorithms::multi_multi_source_cost1(
 	const int& num_thread_)
 {
 	auto list_o = list_o_;
+	for (auto& sources : list_o) sources = find_nodes(sources);
 	auto method = method_;
-	auto target = target_;
+	auto target = find_node(target_);
 	auto cut_off = cut_off_;
 	auto weight_name = weight_name_;
 	auto num_thread = num_thread_;
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 	// 逻辑执行
 	vector<unordered_map<int, double>> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
 	vector<thread> threads;
 	atomic<size_t> index(0);
 	size_t max_threads = std::thread::hardware_concurrency();
 	if (num_thread >= max_threads) num_thread = max_threads - 1;
+	if (num_thread < 1) num_thread = 1;
 
 	// 使用互斥锁来保护 final_result 的访问
 	std::mutex result_mutex;
@@ -2356,7 +5490,7 @@ vector<unordered_map<int, double>> GraphAlgorithms::multi_multi_source_cost1(
 
 					// 执行 Dijkstra 或其他算法
 					if (method == "Dijkstra") {
-						unordered_map<int, double> result = multi_source_dijkstra_cost(weight_map, cur_list, target, cut_off, weight_name);
+						unordered_map<int, double> result = cost_to_map(multi_source_dijkstra_cost(g, weight_index, cur_list, target, cut_off));
 
 						// 使用互斥锁保护对 final_result 的访问
 						std::lock_guard<std::mutex> lock(result_mutex);
@@ -2388,19 +5522,22 @@ vector<unordered_map<int, vector<int>>> GraphAlgorithms::multi_multi_source_path
 	const int& num_thread_)
 {
 	auto list_o = list_o_;
+	for (auto& sources : list_o) sources = find_nodes(sources);
 	auto method = method_;
-	auto target = target_;
+	auto target = find_node(target_);
 	auto cut_off = cut_off_;
 	auto weight_name = weight_name_;
 	auto num_thread = num_thread_;
 
-	const auto& weight_map = get_weight_map(weight_name);
+	int weight_index = get_weight_index(weight_name);
+	const CSRGraph& g = csr;
 	// 逻辑执行
 	vector<unordered_map<int, vector<int>>> final_result(list_o.size());  // 初始化 final_result 容器，大小与 list_o 相同
 	vector<thread> threads;
 	atomic<size_t> index(0);
 	size_t max_threads = std::thread::hardware_concurrency();
 	if (num_thread >= max_threads) num_thread = max_threads - 1;
+	if (num_thread < 1) num_thread = 1;
 
 	// 使用互斥锁来保护 final_result 的访问
 	std::mutex result_mutex;
@@ -2417,7 +5554,7 @@ vector<unordered_map<int, vector<int>>> GraphAlgorithms::multi_multi_source_path
 
 					// 执行 Dijkstra 或其他算法
 					if (method == "Dijkstra") {
-						unordered_map<int, vector<int>> result = multi_source_dijkstra_path(weight_map, cur_list, target, cut_off, weight_name);
+						unordered_map<int, vector<int>> result = path_to_map(multi_source_dijkstra(g, weight_index, cur_list, target, cut_off));
 
 						// 使用互斥锁保护对 final_result 的访问
 						std::lock_guard<std::mutex> lock(result_mutex);
@@ -4,89 +4,433 @@
 // 图计算继承类（主要是算法）
 class GraphAlgorithms : public CGraph {
 public:
-	Graph GTemp;
+	CSRGraph csr; // 只读CSR快照
+	shared_ptr<MappedRegion> published; // 本进程发布的共享内存段
+	set<string> prepared_fields; // 常驻权重列：快照重建时随之重建
+	future<CSRGraph> compacting; // 后台合并增量层的结果
+	long long compact_generation = -1; // 后台合并所基于的快照代号
+	size_t compact_log_size = 0; // 后台合并开始时已回放的增删记录数
+	ChainIndex chains; // 度为 2 的链收缩
+	SpatialGrid spatial; // 节点与边的空间索引
+	long long coord_check_graph = -1; // 坐标完整性检查对应的图版本
+	long long coord_check_coord = -1; // 坐标完整性检查对应的坐标版本
+	bool coords_complete = false; // 非形心节点是否全部有坐标
+	unordered_map<string, LandmarkIndex> alt_index; // 权重字段 -> ALT 路标索引
+	unordered_map<string, ContractionHierarchy> ch_index; // 权重字段 -> 收缩层次
+	MultilevelOverlay overlay; // CRP 多层分区（与权重无关）
+	unordered_map<string, OverlayMetric> overlay_metric; // 权重字段 -> 覆盖图团花费
+
+	// 快照构建 ---------------------------------------------------------------------------------------
+	// 构建CSR快照
+	void freeze();
+
+
+	// 获取CSR快照（少量增删边并入增量层，其余修改后整体重建）
+	const CSRGraph& get_csr();
+
+
+	// 将一条增删记录并入快照的增量层
+	void apply_edge_edit(
+		CSRGraph& g,
+		const EdgeEdit& edit);
+
+
+	// 将增量层合并为新的基础 CSR（后台执行）
+	void compact(
+		bool wait);
+
+
+	// 采用后台合并结果；wait 为 false 时仅在合并已完成时采用
+	void finish_compact(
+		bool wait);
+
+
+	// 获取权重列序号（首次使用时构建该字段的权重列）
+	int get_weight_index(
+		const string& weight_name);
+
+
+	// 按边号收集字段 f 的正反向权重列
+	void build_weight_column(
+		int f,
+		vector<weight_t>& out_w,
+		vector<weight_t>& in_w);
+
+
+	// 预构建权重列，并在图修改后随快照重建
+	void prepare_weight(
+		const string& weight_name);
+
+
+	// 释放权重列，取消常驻
+	void drop_weight(
+		const string& weight_name);
+
+
+	// 统计内存用量（含CSR快照、权重列与增量层）
+	void collect_memory_usage(
+		MemoryUsage& usage) const override;
+
+
+	// 权重更新 ---------------------------------------------------------------------------------------
+	// 批量原地修改边权重，返回实际更新的边数
+	int update_edge_weights(
+		const py::array& u_,
+		const py::array& v_,
+		const py::array& values_,
+		const string& field);
+
+
+	// 节点重排 ---------------------------------------------------------------------------------------
+	// 按局部性重排内部索引（BFS、RCM 逆 Cuthill-McKee、Hilbert 坐标曲线）并重建快照
+	void reorder_nodes(
+		const string& method);
+
+
+	// 链收缩 -----------------------------------------------------------------------------------------
+	// 启用或关闭度为 2 的链收缩（启用时立即构建收缩图）
+	void contract_chains(
+		bool enable);
+
+
+	// 按当前快照构建收缩图
+	void build_chains();
+
+
+	// 选择路由所用的图：启用收缩且各端点均不是链内部节点时返回收缩图，否则返回快照
+	const CSRGraph& route_graph(
+		const vector<int>& nodes,
+		const string& weight_name,
+		int& weight_index);
+
+
+	// 收缩图上的路径展开为原图路径
+	vector<int> expand_path(
+		const vector<int>& path) const;
+
+
+	// 收缩图上的搜索结果补全链内部节点的花费与前驱，经捷径到达的节点前驱改为链上节点
+	void expand_result(
+		SearchResult& result,
+		int weight_index,
+		double cut_off) const;
+
+
+	// 空间索引 ---------------------------------------------------------------------------------------
+	// 获取空间索引（坐标或图修改后重建）
+	const SpatialGrid& get_spatial();
+
+
+	// 批量查询每个坐标最近的 k 个节点（形心点除外），返回节点编号与距离矩阵
+	py::dict nearest_nodes(
+		const py::array& x_,
+		const py::array& y_,
+		int k,
+		int num_thread);
+
+
+	// 批量查询每个坐标 radius 范围内的边（形心边除外），返回按查询、距离排序的投影点与沿边偏移
+	py::dict nearest_edges(
+		const py::array& x_,
+		const py::array& y_,
+		double radius,
+		int num_thread);
+
+
+	// 路标索引 ---------------------------------------------------------------------------------------
+	// 为权重字段构建 ALT 路标索引（selection 为 "farthest" 或 "avoid"），各路标的正反向搜索并行执行
+	void build_landmarks(
+		const string& weight_name,
+		int num_landmarks,
+		const string& selection,
+		int num_thread);
+
+
+	// 获取权重字段的路标索引（图或权重修改后按原参数重建），未构建时抛出 runtime_error
+	const LandmarkIndex& get_landmarks(
+		const string& weight_name);
+
+
+	// 按索引中的参数选择路标并计算正反向花费
+	void compute_landmarks(
+		LandmarkIndex& index,
+		int weight_index);
+
+
+	// 收缩层次 ---------------------------------------------------------------------------------------
+	// 为权重字段构建收缩层次（节点排序、见证搜索、捷径）
+	void build_ch(
+		const string& weight_name);
+
+
+	// 获取权重字段的收缩层次（图或权重修改后重建），未构建时抛出 runtime_error
+	const ContractionHierarchy& get_ch(
+		const string& weight_name);
+
+
+	// 按快照权重列收缩全部节点
+	void compute_ch(
+		ContractionHierarchy& ch,
+		int weight_index);
+
+
+	// 多层覆盖图 -------------------------------------------------------------------------------------
+	// 构建多层分区覆盖图（与权重无关的预处理），已定制的权重字段在下次查询时重新定制
+	void build_overlay(
+		int cell_size,
+		int num_levels,
+		int fanout);
+
+
+	// 按权重字段并行定制各层团花费（权重修改后重新调用即可，无需重建分区）
+	void customize_overlay(
+		const string& weight_name,
+		int num_thread);
+
+
+	// 获取覆盖图（图修改后按原参数重建），未构建时抛出 runtime_error
+	const MultilevelOverlay& get_overlay();
+
+
+	// 获取权重字段的团花费（图或权重修改后按原参数重新定制），未定制时抛出 runtime_error
+	const OverlayMetric& get_overlay_metric(
+		const string& weight_name);
+
+
+	// 按快照拓扑逐层区域生长划分单元，并确定各单元的入口与出口
+	void compute_overlay(
+		MultilevelOverlay& ov);
+
+
+	// 自底向上逐层计算团花费，同层单元并行
+	void compute_overlay_metric(
+		const MultilevelOverlay& ov,
+		OverlayMetric& metric,
+		int weight_index);
+
+
+	// 图像文件 ---------------------------------------------------------------------------------------
+	// 保存为二进制图像文件（拓扑、属性列、形心标记、编号映射）
+	void save(
+		const string& path);
+
+
+	// 映射加载图像文件，替换当前图
+	void load(
+		const string& path);
+
+
+	// 将图发布到具名共享内存段，供其他进程只读挂接
+	void publish_shared(
+		const string& name);
+
+
+	// 挂接其他进程发布的具名共享内存段，替换当前图（零拷贝）
+	void attach_shared(
+		const string& name);
+
+
+	// 删除具名共享内存段（已挂接的进程不受影响）
+	static void unlink_shared(
+		const string& name);
+
+
+	// 生成图像各段
+	void build_image(
+		const function<void(const ImageWriter&, const ImageHeader&)>& sink);
+
+
+	// 加载映射区域中的图像
+	void load_region(
+		const shared_ptr<MappedRegion>& region,
+		const string& path);
+
+
+	// 结果转换 ---------------------------------------------------------------------------------------
+	// 花费结果转字典
+	unordered_map<int, double> cost_to_map(
+		const SearchResult& result) const;
+
+
+	// 路径结果转字典
+	unordered_map<int, vector<int>> path_to_map(
+		const SearchResult& result) const;
+
+
+	// 路径花费结果转字典
+	dis_and_path all_to_map(
+		const SearchResult& result) const;
+
+
+	// 路径转原始编号
+	vector<int> path_to_external(
+		const vector<int>& path) const;
 
 	// 核心算法 ---------------------------------------------------------------------------------------
-	// 多源花费
-	unordered_map<int, double> multi_source_dijkstra_cost(
-		const unordered_map<int, vector<pair<int, double>>>& g,
+	// 解析方法名："Dijkstra" 及其优先队列变体（"Dijkstra-4ary"、"Dijkstra-radix"、"Dijkstra-dial"），其他方法返回 QueueKind::None
+	static QueueKind dijkstra_queue(
+		const string& method);
+
+
+	// 多源花费（按优先队列类型实例化，目标集全部确定后停止）
+	template <typename Queue>
+	SearchResult dijkstra_search(
+		const CSRGraph& g,
+		int weight_index,
 		const vector<int>& sources,
-		int& target,
-		double& cut_off,
-		string& weight_name);
+		const vector<int>& targets,
+		double cut_off);
 
 
-	// 多源路径
-	unordered_map<int, vector<int>> multi_source_dijkstra_path(
-		const unordered_map<int, vector<pair<int, double>>>& g,
+	// 多源花费（目标集为空时搜索 cut_off 内的全部节点）
+	SearchResult multi_source_dijkstra_cost(
+		const CSRGraph& g,
+		int weight_index,
 		const vector<int>& sources,
-		int target,
+		const vector<int>& targets,
 		double cut_off,
-		string weight_name);
+		QueueKind queue = QueueKind::Binary);
 
 
-	// 多源路径花费
-	dis_and_path multi_source_dijkstra(
-		const unordered_map<int, vector<pair<int, double>>>& g,
+	// 多源花费（单个目标，-1 表示无目标）
+	SearchResult multi_source_dijkstra_cost(
+		const CSRGraph& g,
+		int weight_index,
 		const vector<int>& sources,
 		int target,
 		double cut_off,
-		string weight_name);
+		QueueKind queue = QueueKind::Binary);
 
 
-	// 多源路径花费形心点
-	unordered_map<int, double> multi_source_dijkstra_cost_centroid(
+	// 多源路径花费
+	SearchResult multi_source_dijkstra(
+		const CSRGraph& g,
+		int weight_index,
 		const vector<int>& sources,
 		int target,
 		double cut_off,
-		string weight_name);
+		QueueKind queue = QueueKind::Binary);
 
 
-	// 非全勤权重邻接字典获取
-	unordered_map<int, vector<pair<int, double>>> weight_func(
-		string weight_name);
+	// 多源路径花费形心点（按优先队列类型实例化，目标集全部确定后停止）
+	template <typename Queue>
+	SearchResult dijkstra_search_centroid(
+		const CSRGraph& g,
+		int weight_index,
+		const vector<int>& sources,
+		const vector<int>& targets,
+		double cut_off,
+		const string& weight_name);
 
 
-	// 非全勤权重前导字典获取
-	unordered_map<int, vector<pair<int, double>>> weight_reverse_func(
-		string weight_name);
+	// 多源路径花费形心点（目标集为空时搜索 cut_off 内的全部节点）
+	SearchResult multi_source_dijkstra_cost_centroid(
+		const CSRGraph& g,
+		int weight_index,
+		const vector<int>& sources,
+		const vector<int>& targets,
+		double cut_off,
+		const string& weight_name,
+		QueueKind queue = QueueKind::Binary);
 
 
-	// 获取正向权重
-	const unordered_map<int, vector<pair<int, double>>>&
-		get_weight_map(const string& weight_name);
+	// 多源路径花费形心点（单个目标，-1 表示无目标）
+	SearchResult multi_source_dijkstra_cost_centroid(
+		const CSRGraph& g,
+		int weight_index,
+		const vector<int>& sources,
+		int target,
+		double cut_off,
+		const string& weight_name,
+		QueueKind queue = QueueKind::Binary);
 
 
-	// 获取反向权重
-	const unordered_map<int, vector<pair<int, double>>>&
-		get_weight_reverse_map(const string& weight_name);
+	// 剔除超过 cut_off 的节点
+	void filter_cut_off(
+		SearchResult& result,
+		double cut_off);
 
 
-	// 双向Dijkstra算法
+	// 双向Dijkstra算法（给定路标索引且为单源时以 ALT 下界导向）
 	dis_and_path bidirectional_dijkstra(
-		const unordered_map<int, vector<pair<int, double>>>& reverse_g,
-		const unordered_map<int, vector<pair<int, double>>>& g,
+		const CSRGraph& g,
+		int weight_index,
 		const vector<int>& sources,
 		int target,
-		double cut_off);
+		double cut_off,
+		const LandmarkIndex* landmarks = nullptr);
 
 
-	// 双向Dijkstra算法 存在ignore
+	// 双向Dijkstra算法 存在ignore（给定路标索引且为单源时以 ALT 下界导向）
 	dis_and_path bidirectional_dijkstra_ignore(
-		const unordered_map<int, vector<pair<int, double>>>& reverse_g,
-		const unordered_map<int, vector<pair<int, double>>>& g,
+		const CSRGraph& g,
+		int weight_index,
 		const vector<int>& sources,
 		int target,
 		double cut_off,
 		const set<int>& ignore_nodes,
+		const set<pair<int, int>>& ignore_edges,
+		const LandmarkIndex* landmarks = nullptr);
+
+
+	// 双向目标导向搜索：正向键为 花费 + potential(v)，反向键为 花费 - potential(v)，potential 须使约化边权非负
+	template <typename Potential>
+	dis_and_path bidirectional_goal_search(
+		const CSRGraph& g,
+		int weight_index,
+		int source,
+		int target,
+		double cut_off,
+		const Potential& potential,
+		const set<int>& ignore_nodes,
 		const set<pair<int, int>>& ignore_edges);
 
 
+	// 检查 A* 所需坐标：非形心节点须全部有坐标，max_speed 须为正，否则抛出 runtime_error
+	void check_astar(
+		double max_speed);
+
+
+	// A*算法（启发值为到终点的直线距离 / max_speed）
+	dis_and_path astar(
+		const CSRGraph& g,
+		int weight_index,
+		int source,
+		int target,
+		double max_speed);
+
+
+	// 双向A*算法（正反向使用平均势函数）
+	dis_and_path bidirectional_astar(
+		const CSRGraph& g,
+		int weight_index,
+		int source,
+		int target,
+		double max_speed);
+
+
+	// 收缩层次上的点到点查询（内部索引），路径展开为原图路径，花费按原图边权沿路径累加
+	dis_and_path ch_query(
+		const ContractionHierarchy& ch,
+		int weight_index,
+		int source,
+		int target);
+
+
+	// 多层覆盖图上的点到点查询（内部索引），团弧逐层展开为原图路径，花费按原图边权沿路径累加
+	dis_and_path crp_query(
+		const MultilevelOverlay& ov,
+		const OverlayMetric& metric,
+		int weight_index,
+		int source,
+		int target);
+
+
 	// 计算长度
 	double calculate_path_length(
-		const unordered_map<int, vector<pair<int, double>>>& g,
-		const vector<int>& path,
-		const string& weight);
+		const CSRGraph& g,
+		int weight_index,
+		const vector<int>& path);
 
 
 	// 获取K条最短路径 K大于一定值时
@@ -94,7 +438,8 @@ public:
 		int source,
 		int target,
 		int K,
-		const string& weight_name);
+		const string& weight_name,
+		const string& method = "Dijkstra");
 
 
 	// 获取K条最短路径 K小于一定值时
@@ -102,12 +447,71 @@ public:
 		int source,
 		int target,
 		int K,
-		const string& weight_name);
+		const string& weight_name,
+		const string& method = "Dijkstra");
 
+	// 单个OD对的花费与路径：method 为 "Dijkstra"（双向Dijkstra）、"AStar"、"BiAStar"、"ALT"（须先构建路标索引）或 "CH"（须先构建收缩层次）
 	pair<double, vector<int>> single_source_to_target(
 		int source,
 		int target,
-		const string& weight_name);
+		const string& weight_name,
+		const string& method = "Dijkstra",
+		double max_speed = 1.0);
+
+
+	// 各起点到各终点的路径（原始编号，不可达为空），每个起点搜索至终点全部确定，只回溯所需终点
+	vector<vector<vector<int>>> paths_to_targets(
+		const vector<int>& starts,
+		const vector<int>& ends,
+		double cut_off,
+		const string& weight_name,
+		int num_thread,
+		QueueKind queue = QueueKind::Binary);
+
+
+	// 各组源点到目标集的花费（内部索引，centroid 为真时按形心规则搜索），结果以原始编号为键，只含 cut_off 内到达的目标
+	vector<unordered_map<int, double>> costs_to_targets(
+		const vector<vector<int>>& list_o,
+		const vector<int>& targets,
+		double cut_off,
+		const string& weight_name,
+		int num_thread,
+		QueueKind queue,
+		bool centroid);
+
+
+	// 收缩层次上的多对多桶算法（按形心规则）：各目标向上搜索填充途经节点的桶，各组源点向上搜索扫描桶取最小和
+	// 结果格式同 costs_to_targets
+	vector<unordered_map<int, double>> ch_costs_to_targets(
+		const ContractionHierarchy& ch,
+		const vector<vector<int>>& list_o,
+		const vector<int>& targets,
+		double cut_off,
+		const string& weight_name,
+		int num_thread);
+
+
+	// 收缩层次上的 PHAST 一到全部花费：各源点向上搜索后按收缩次序线性扫描向下弧，每次扫描处理一批源点
+	// 源点为内部索引（形心点从其出边终点开始，-1 对应空结果），结果以原始编号为键，只含 cut_off 内的节点
+	vector<unordered_map<int, double>> phast_costs(
+		const ContractionHierarchy& ch,
+		const vector<int>& sources,
+		double cut_off,
+		const string& weight_name,
+		int num_thread);
+
+
+	// 多层覆盖图上各源点到目标集的花费：源点与目标所在单元之外只经团弧与跨单元边，形心源点从其出边终点开始
+	// 源点组为空时结果为空，结果格式同 costs_to_targets
+	vector<unordered_map<int, double>> crp_costs_to_targets(
+		const MultilevelOverlay& ov,
+		const OverlayMetric& metric,
+		const vector<vector<int>>& list_o,
+		const vector<int>& targets,
+		double cut_off,
+		int weight_index,
+		const string& weight_name,
+		int num_thread);
 	// 调用方法 ---------------------------------------------------------------------------------------
 
 
@@ -217,8 +621,28 @@ public:
 		const py::object& num_thread_);
 
 
-	// 花费矩阵
-	py::array_t<double> cost_matrix_to_numpy(
+	// 多个单源到目标集的花费：每个起点搜索至目标全部确定，结果只含 cut_off 内到达的目标
+	vector<unordered_map<int, double>> multi_single_source_cost_targets(
+		const py::object& list_o_,
+		const py::object& targets_,
+		const py::object& method_,
+		const py::object& cut_off_,
+		const py::object& weight_name_,
+		const py::object& num_thread_);
+
+
+	// 多个多源到目标集的花费
+	vector<unordered_map<int, double>> multi_multi_source_cost_targets(
+		const py::object& list_o_,
+		const py::object& targets_,
+		const py::object& method_,
+		const py::object& cut_off_,
+		const py::object& weight_name_,
+		const py::object& num_thread_);
+
+
+	// 花费矩阵（紧凑模式下为 float32）
+	py::array_t<cost_t> cost_matrix_to_numpy(
 		const py::object& starts,
 		const py::object& ends,
 		const py::object& method_,
@@ -252,28 +676,35 @@ public:
 		const py::object& source,
 		const py::object& target,
 		const py::object& num_k,
-		const py::object& weight_name);
+		const py::object& weight_name,
+		const py::object& method);
 
 
 	// 单源节点到目标点的花费
 	double shortest_path_cost(
 		const py::object& source_,
 		const py::object& target_,
-		const py::object& weight_name_);
+		const py::object& weight_name_,
+		const py::object& method_,
+		const py::object& max_speed_);
 
 
 	// 单源节点到目标点的路径
 	vector<int> shortest_path_path(
 		const py::object& source_,
 		const py::object& target_,
-		const py::object& weight_name_);
+		const py::object& weight_name_,
+		const py::object& method_,
+		const py::object& max_speed_);
 
 
 	// 单源节点到目标点的路径
 	pair<double,vector<int>> shortest_path_all(
 		const py::object& source_,
 		const py::object& target_,
-		const py::object& weight_name_);
+		const py::object& weight_name_,
+		const py::object& method_,
+		const py::object& max_speed_);
 
 	// test-------------------------------------------------------------------
 	
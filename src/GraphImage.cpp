@@ -0,0 +1,279 @@
+#include "GraphImage.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// 内存映射 ---------------------------------------------------------------------------------------
+#ifdef _WIN32
+shared_ptr<MappedRegion> MappedRegion::open_file(
+	const string& path)
+{
+	shared_ptr<MappedRegion> region(new MappedRegion());
+
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		throw runtime_error("cannot open graph image '" + path + "'");
+	}
+	region->file_handle = file;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		throw runtime_error("graph image '" + path + "' is empty");
+	}
+	region->length = static_cast<size_t>(file_size.QuadPart);
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		throw runtime_error("cannot map graph image '" + path + "'");
+	}
+	region->mapping_handle = mapping;
+
+	region->base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (region->base == nullptr) {
+		throw runtime_error("cannot map graph image '" + path + "'");
+	}
+	return region;
+}
+
+
+shared_ptr<MappedRegion> MappedRegion::create_shared(
+	const string& name,
+	size_t size)
+{
+	shared_ptr<MappedRegion> region(new MappedRegion());
+
+	// 具名映射由系统分页文件支撑，最后一个句柄关闭时释放
+	HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+		static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size & 0xFFFFFFFFu), name.c_str());
+	if (mapping == nullptr) {
+		throw runtime_error("cannot create shared graph '" + name + "'");
+	}
+	region->mapping_handle = mapping;
+
+	region->base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size));
+	if (region->base == nullptr) {
+		throw runtime_error("cannot map shared graph '" + name + "'");
+	}
+	region->length = size;
+	region->writable = true;
+	return region;
+}
+
+
+shared_ptr<MappedRegion> MappedRegion::open_shared(
+	const string& name)
+{
+	shared_ptr<MappedRegion> region(new MappedRegion());
+
+	HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+	if (mapping == nullptr) {
+		throw runtime_error("shared graph '" + name + "' does not exist");
+	}
+	region->mapping_handle = mapping;
+
+	region->base = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (region->base == nullptr) {
+		throw runtime_error("cannot map shared graph '" + name + "'");
+	}
+	MEMORY_BASIC_INFORMATION info;
+	VirtualQuery(region->base, &info, sizeof(info));
+	region->length = info.RegionSize;
+	return region;
+}
+
+
+void MappedRegion::remove_shared(
+	const string& name)
+{
+	// Windows 下具名映射随最后一个句柄释放，无需显式删除
+}
+
+
+MappedRegion::~MappedRegion()
+{
+	if (base != nullptr) UnmapViewOfFile(base);
+	if (mapping_handle != nullptr) CloseHandle(mapping_handle);
+	if (file_handle != nullptr) CloseHandle(file_handle);
+}
+#else
+shared_ptr<MappedRegion> MappedRegion::open_file(
+	const string& path)
+{
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		throw runtime_error("cannot open graph image '" + path + "'");
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		throw runtime_error("graph image '" + path + "' is empty");
+	}
+
+	// 映射建立后即可关闭文件描述符
+	void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		throw runtime_error("cannot map graph image '" + path + "'");
+	}
+
+	shared_ptr<MappedRegion> region(new MappedRegion());
+	region->base = static_cast<const char*>(base);
+	region->length = static_cast<size_t>(st.st_size);
+	return region;
+}
+
+
+// POSIX 共享内存名须以 '/' 开头
+static string shared_memory_name(
+	const string& name)
+{
+	return (!name.empty() && name[0] == '/') ? name : "/" + name;
+}
+
+
+shared_ptr<MappedRegion> MappedRegion::create_shared(
+	const string& name,
+	size_t size)
+{
+	string shm_name = shared_memory_name(name);
+	shm_unlink(shm_name.c_str()); // 替换同名旧段，已映射的进程不受影响
+
+	int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd == -1) {
+		throw runtime_error("cannot create shared graph '" + name + "'");
+	}
+	if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+		close(fd);
+		shm_unlink(shm_name.c_str());
+		throw runtime_error("cannot allocate " + to_string(size) + " bytes for shared graph '" + name + "'");
+	}
+
+	void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		shm_unlink(shm_name.c_str());
+		throw runtime_error("cannot map shared graph '" + name + "'");
+	}
+
+	shared_ptr<MappedRegion> region(new MappedRegion());
+	region->base = static_cast<const char*>(base);
+	region->length = size;
+	region->writable = true;
+	return region;
+}
+
+
+shared_ptr<MappedRegion> MappedRegion::open_shared(
+	const string& name)
+{
+	string shm_name = shared_memory_name(name);
+	int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+	if (fd == -1) {
+		throw runtime_error("shared graph '" + name + "' does not exist");
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0) {
+		close(fd);
+		throw runtime_error("shared graph '" + name + "' is empty");
+	}
+
+	void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		throw runtime_error("cannot map shared graph '" + name + "'");
+	}
+
+	shared_ptr<MappedRegion> region(new MappedRegion());
+	region->base = static_cast<const char*>(base);
+	region->length = static_cast<size_t>(st.st_size);
+	return region;
+}
+
+
+void MappedRegion::remove_shared(
+	const string& name)
+{
+	shm_unlink(shared_memory_name(name).c_str());
+}
+
+
+MappedRegion::~MappedRegion()
+{
+	if (base != nullptr) munmap(const_cast<char*>(base), length);
+}
+#endif
+
+
+// 图像写出 ---------------------------------------------------------------------------------------
+vector<ImageSection> ImageWriter::layout(
+	ImageHeader& header) const
+{
+	auto align = [](int64_t offset) {
+		return (offset + GRAPH_IMAGE_ALIGN - 1) / GRAPH_IMAGE_ALIGN * GRAPH_IMAGE_ALIGN;
+	};
+
+	vector<ImageSection> sections(parts.size());
+	int64_t offset = align(sizeof(ImageHeader) + sizeof(ImageSection) * parts.size());
+	for (size_t i = 0; i < parts.size(); ++i) {
+		sections[i].offset = offset;
+		sections[i].bytes = static_cast<int64_t>(parts[i].second);
+		offset = align(offset + sections[i].bytes);
+	}
+	header.num_sections = static_cast<int64_t>(parts.size());
+	header.file_size = offset;
+	return sections;
+}
+
+
+void ImageWriter::write(
+	ostream& out,
+	ImageHeader header) const
+{
+	vector<ImageSection> sections = layout(header);
+
+	// 依次写出文件头、目录、各段（段间补零对齐）
+	const char padding[GRAPH_IMAGE_ALIGN] = {};
+	int64_t written = 0;
+	auto emit = [&](const void* data, int64_t bytes) {
+		out.write(static_cast<const char*>(data), bytes);
+		written += bytes;
+	};
+	auto pad_to = [&](int64_t target) {
+		emit(padding, target - written);
+	};
+
+	emit(&header, sizeof(header));
+	emit(sections.data(), sizeof(ImageSection) * sections.size());
+	for (size_t i = 0; i < parts.size(); ++i) {
+		pad_to(sections[i].offset);
+		emit(parts[i].first, sections[i].bytes);
+	}
+	pad_to(header.file_size);
+}
+
+
+void ImageWriter::write(
+	char* dst,
+	ImageHeader header) const
+{
+	vector<ImageSection> sections = layout(header);
+
+	memset(dst, 0, static_cast<size_t>(header.file_size));
+	memcpy(dst, &header, sizeof(header));
+	memcpy(dst + sizeof(header), sections.data(), sizeof(ImageSection) * sections.size());
+	for (size_t i = 0; i < parts.size(); ++i) {
+		if (sections[i].bytes > 0) memcpy(dst + sections[i].offset, parts[i].first, parts[i].second);
+	}
+}
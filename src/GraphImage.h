@@ -0,0 +1,188 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#pragma once
+
+using namespace std;
+
+// 只读连续数组：自身持有数据，或直接指向内存映射区域（owner 保持映射存活）
+template <typename T>
+class ArrayRef {
+public:
+	ArrayRef() {}
+
+	// 接管 vector 的数据
+	ArrayRef(vector<T>&& values) {
+		auto holder = make_shared<vector<T>>(move(values));
+		ptr = holder->data();
+		writable = holder->data();
+		len = holder->size();
+		owner = move(holder);
+	}
+
+	// 指向外部内存，owner 负责其生命周期
+	ArrayRef(shared_ptr<const void> owner_, const T* ptr_, size_t len_)
+		: owner(move(owner_)), ptr(ptr_), len(len_) {
+	}
+
+	const T& operator[](size_t i) const { return ptr[i]; }
+	const T* begin() const { return ptr; }
+	const T* end() const { return ptr + len; }
+	const T* data() const { return ptr; }
+	size_t size() const { return len; }
+	bool empty() const { return len == 0; }
+
+	// 仅自身持有数据时可原地修改，指向映射区域时返回 nullptr
+	T* mutable_data() const { return writable; }
+
+private:
+	shared_ptr<const void> owner;
+	const T* ptr = nullptr;
+	T* writable = nullptr;
+	size_t len = 0;
+};
+
+
+// 内存映射区域（文件或具名共享内存）
+class MappedRegion {
+public:
+	// 只读映射整个文件，失败抛出 runtime_error
+	static shared_ptr<MappedRegion> open_file(
+		const string& path);
+
+
+	// 新建具名共享内存段并可写映射（同名段已存在时替换）
+	static shared_ptr<MappedRegion> create_shared(
+		const string& name,
+		size_t size);
+
+
+	// 只读映射已发布的具名共享内存段
+	static shared_ptr<MappedRegion> open_shared(
+		const string& name);
+
+
+	// 删除具名共享内存段（已映射的进程不受影响）
+	static void remove_shared(
+		const string& name);
+
+	~MappedRegion();
+
+	const char* data() const { return base; }
+	char* mutable_data() const { return writable ? const_cast<char*>(base) : nullptr; }
+	size_t size() const { return length; }
+
+private:
+	MappedRegion() {}
+
+	const char* base = nullptr;
+	size_t length = 0;
+	bool writable = false;
+#ifdef _WIN32
+	void* file_handle = nullptr;
+	void* mapping_handle = nullptr;
+#endif
+};
+
+
+// 图像文件格式 -----------------------------------------------------------------------------------
+// 布局：ImageHeader | ImageSection[num_sections] | 各段数据（64 字节对齐）
+// 各段按 ImageSectionId 顺序排列，之后每个属性列依次占 IMAGE_SECTIONS_PER_FIELD 段
+const char GRAPH_IMAGE_MAGIC[8] = { 'G', 'W', 'G', 'R', 'A', 'P', 'H', '\0' };
+const uint32_t GRAPH_IMAGE_VERSION = 1;
+const uint32_t GRAPH_IMAGE_BYTE_ORDER = 0x01020304;
+const size_t GRAPH_IMAGE_ALIGN = 64;
+
+struct ImageHeader {
+	char magic[8];
+	uint32_t version; // 格式版本
+	uint32_t byte_order; // 字节序校验
+	int64_t num_nodes; // 节点数
+	int64_t num_edges; // CSR 边数（非形心边）
+	int64_t num_centroid_edges; // 形心边数
+	int64_t num_fields; // 属性列数
+	int64_t number_link; // 总边数
+	int64_t num_sections; // 段数
+	int64_t file_size; // 文件总字节数
+};
+
+struct ImageSection {
+	int64_t offset; // 相对文件头的字节偏移
+	int64_t bytes; // 字节数
+};
+
+enum ImageSectionId {
+	IMAGE_NODE_IDS, // int32[num_nodes]，内部索引 -> 原始编号
+	IMAGE_SORTED_IDS, // int32[num_nodes]，升序原始编号
+	IMAGE_SORTED_INDEX, // int32[num_nodes]，与 IMAGE_SORTED_IDS 对应的内部索引
+	IMAGE_CENTROID_FLAG, // uint8[num_nodes]，形心点标记
+	IMAGE_OUT_OFFSET, // int32[num_nodes + 1]
+	IMAGE_OUT_TARGET, // int32[num_edges]
+	IMAGE_IN_OFFSET, // int32[num_nodes + 1]
+	IMAGE_IN_SOURCE, // int32[num_edges]
+	IMAGE_FIELD_NAMES, // 以 '\0' 结尾的字段名依次拼接
+	IMAGE_FIELD_COUNT, // int64[num_fields]，字段出现数
+	IMAGE_CENTROID_FROM, // int32[num_centroid_edges]
+	IMAGE_CENTROID_TO, // int32[num_centroid_edges]
+	IMAGE_CENTROID_VALUES, // double[num_fields * num_centroid_edges]，按字段排列，缺失为 NaN
+	IMAGE_FIXED_SECTIONS
+};
+
+enum ImageFieldSection {
+	IMAGE_FIELD_OUT_WEIGHT, // double[num_edges]，与 out_target 对齐
+	IMAGE_FIELD_IN_WEIGHT, // double[num_edges]，与 in_source 对齐
+	IMAGE_FIELD_OUT_PRESENT, // uint64[(num_edges + 63) / 64]，按 CSR 位置的存在位图
+	IMAGE_SECTIONS_PER_FIELD
+};
+
+
+// 图像写出：收集各段数据后统一计算布局
+class ImageWriter {
+public:
+	// 追加一段（数据需在写出前保持有效）
+	void add(const void* data, size_t bytes) {
+		parts.emplace_back(data, bytes);
+	}
+
+	template <typename T>
+	void add(const vector<T>& values) {
+		add(values.data(), values.size() * sizeof(T));
+	}
+
+	template <typename T>
+	void add(const ArrayRef<T>& values) {
+		add(values.data(), values.size() * sizeof(T));
+	}
+
+	// 按 header 计算目录，补全段数与文件大小
+	vector<ImageSection> layout(ImageHeader& header) const;
+
+
+	// 写出到流
+	void write(ostream& out, ImageHeader header) const;
+
+
+	// 写出到内存（dst 至少 layout 后 header.file_size 字节）
+	void write(char* dst, ImageHeader header) const;
+
+private:
+	vector<pair<const void*, size_t>> parts;
+};
+
+
+// 映射加载的图像：CGraph 延迟重建可变结构期间，由其提供节点查找与形心标记
+struct GraphImage {
+	bool active = false; // 可变结构尚未重建
+	ArrayRef<int> sorted_ids; // 升序原始编号
+	ArrayRef<int> sorted_index; // 对应内部索引
+	ArrayRef<uint8_t> centroid_flag; // 形心点标记
+	ArrayRef<int> out_offset; // 正向邻接偏移
+	ArrayRef<int> out_target; // 正向邻接终点
+	vector<ArrayRef<double>> out_weight; // 属性列号 -> 正向权重
+	vector<ArrayRef<double>> in_weight; // 属性列号 -> 反向权重
+	vector<ArrayRef<uint64_t>> out_present; // 属性列号 -> 存在位图
+};
@@ -2,6 +2,12 @@ import graphwork
 from typing import Optional, Type
 import numpy as np
 
+# 最短路算法：标准 Dijkstra 及其优先队列变体
+DIJKSTRA_METHODS = ["Dijkstra", "Dijkstra-4ary", "Dijkstra-radix", "Dijkstra-dial"]
+
+# 点到点最短路算法：双向 Dijkstra、基于节点坐标的 A*、基于路标的 ALT、收缩层次与多层覆盖图
+POINT_TO_POINT_METHODS = ["Dijkstra", "AStar", "BiAStar", "ALT", "CH", "CRP"]
+
 
 class CGraph:
     def __init__(self):
@@ -18,6 +24,22 @@ class CGraph:
         result = self.graph.get_graph_info()
         return result
 
+    def get_memory_usage(self) -> dict:
+        """**类方法 - get_memory_usage:** <br>
+        - 获取图各结构的内存用量（字节）
+
+        说明:
+            按结构（G、m_node_map、in_edges、edge_attr、csr_topology、csr_weights 等）给出堆内存估算值，
+            包含哈希表桶数组、节点与分配器块头的开销；"total" 为堆内存合计，
+            "mapped" 为映射区域（图像文件、共享内存）的字节数，不计入 "total"。
+            get_graph_info 的 "memory_usage" 项与此相同。
+
+        Returns:
+              dict: 结构名 -> 字节数
+        """
+        result = self.graph.get_memory_usage()
+        return result
+
     def get_node_info(self,
                       id: int) -> dict:
         """**类方法 - get_node_info:** <br>
@@ -190,6 +212,37 @@ class CGraph:
         # 如果所有检查通过，调用 graph.add_edges
         self.graph.add_edges(edges)
 
+    def add_edges_from_arrays(self,
+                              u: np.ndarray,
+                              v: np.ndarray,
+                              **fields: np.ndarray) -> None:
+        """**类方法 - add_edges_from_arrays:**<br>
+         - 从 numpy 数组批量加边（不逐条转换 Python 对象，建图期间释放 GIL）
+
+         Args:
+             u (np.ndarray): 边的起始节点，一维 int32/int64 数组。
+             v (np.ndarray): 边的结束节点，一维 int32/int64 数组，长度与 u 相同。
+             **fields (np.ndarray): 边属性列，字段名 = 一维数值数组，长度与 u 相同。值为 NaN 表示该边缺失此字段。
+
+         Raises:
+             ValueError: 如果“u”、“v”或字段值不是 numpy 数组。
+             RuntimeError: 如果数组维度、长度或 dtype 不符合要求，或节点编号超出 int32 范围（在 C++ 中统一校验）。
+
+         Example:
+             g.add_edges_from_arrays(df["from"].values, df["to"].values, length=df["length"].values)
+         """
+        if 1:
+            # 只检查容器类型，dtype 与长度在 C++ 中一次性校验
+            if not isinstance(u, np.ndarray):
+                raise ValueError(f"Expected 'u' to be a numpy.ndarray, but got {type(u)}.")
+            if not isinstance(v, np.ndarray):
+                raise ValueError(f"Expected 'v' to be a numpy.ndarray, but got {type(v)}.")
+            for name, values in fields.items():
+                if not isinstance(values, np.ndarray):
+                    raise ValueError(f"Expected field '{name}' to be a numpy.ndarray, but got {type(values)}.")
+
+        self.graph.add_edges_from_arrays(u, v, **fields)
+
     def remove_edge(self,
                     start: int,
                     end: int) -> None:
@@ -240,6 +293,500 @@ class CGraph:
 
         self.graph.remove_edges(edges)
 
+    def set_node_coords(self,
+                        nodes: np.ndarray,
+                        x: np.ndarray,
+                        y: np.ndarray) -> int:
+        """**类方法 - set_node_coords：**<br>
+         - 从 numpy 数组批量设置节点坐标
+
+        说明:
+            坐标供 nearest_nodes、nearest_edges 与 reorder_nodes(method="Hilbert") 等依赖几何位置的功能使用，
+            不影响最短路径计算。
+            图中不存在的节点被跳过，未设置坐标的节点视为缺失。坐标不写入图像文件。
+
+        Args:
+            nodes (np.ndarray): 节点编号，一维 int32/int64 数组。
+            x (np.ndarray): x 坐标（如经度），一维数值数组，长度与 nodes 相同。
+            y (np.ndarray): y 坐标（如纬度），一维数值数组，长度与 nodes 相同。
+
+        Raises:
+            ValueError: 如果“nodes”、“x”或“y”不是 numpy 数组。
+            RuntimeError: 如果数组维度、长度或 dtype 不符合要求，或节点编号超出 int32 范围（在 C++ 中统一校验）。
+
+        Returns:
+            int: 实际设置坐标的节点数。
+        """
+        if 1:
+            # 只检查容器类型，dtype 与长度在 C++ 中一次性校验
+            for name, arr in (("nodes", nodes), ("x", x), ("y", y)):
+                if not isinstance(arr, np.ndarray):
+                    raise ValueError(f"Expected '{name}' to be a numpy.ndarray, but got {type(arr)}.")
+
+        return self.graph.set_node_coords(nodes, x, y)
+
+    def freeze(self) -> None:
+        """**类方法 - freeze：**<br>
+         - 构建只读CSR快照（正反向拓扑 + 按字段的权重列）
+
+        说明:
+            所有最短路径计算都在快照上进行；图被修改后，下一次计算会自动重建快照。
+            加载完路网后主动调用一次，可将构建耗时移出首次查询。
+        """
+        self.graph.freeze()
+
+    def compact(self,
+                wait: bool = False) -> None:
+        """**类方法 - compact：**<br>
+         - 将快照的增量层合并为新的紧凑快照（后台执行）
+
+        说明:
+            快照建立后，少量加边进入仅追加的增量层，删边在快照上打墓碑标记，查询看到的是合并视图，
+            无需整体重建。增删累积较多时可调用本方法在后台线程合并，合并期间查询与增删照常进行，
+            合并完成后在下次查询时自动换用新快照。增量层超过边数的四分之一时自动整体重建。
+
+        Args:
+            wait (bool): 是否等待合并完成后再返回，默认为 False。
+
+        Raises:
+            ValueError: 如果“wait”不是布尔值。
+        """
+        if not isinstance(wait, bool):
+            raise ValueError(f"Invalid value for 'wait': {wait}. It must be a boolean.")
+
+        self.graph.compact(wait)
+
+    def prepare_weight(self,
+                       weight_name: str) -> None:
+        """**类方法 - prepare_weight：**<br>
+         - 预构建某个字段的权重列，并使其常驻
+
+        说明:
+            权重列默认在首次按该字段计算时构建，图被修改后失效并在下次使用时重建。
+            常驻字段在快照重建时一并重建，适合在会话中交替使用多个权重（如时间、距离）。
+
+        Args:
+            weight_name (str): 边权重字段名。
+
+        Raises:
+            ValueError: 如果“weight_name”不是字符串。
+        """
+        if not isinstance(weight_name, str):
+            raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be a string.")
+
+        self.graph.prepare_weight(weight_name)
+
+    def drop_weight(self,
+                    weight_name: str) -> None:
+        """**类方法 - drop_weight：**<br>
+         - 释放某个字段的权重列并取消常驻，下次使用时重新构建
+
+        Args:
+            weight_name (str): 边权重字段名。
+
+        Raises:
+            ValueError: 如果“weight_name”不是字符串。
+        """
+        if not isinstance(weight_name, str):
+            raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be a string.")
+
+        self.graph.drop_weight(weight_name)
+
+    def reorder_nodes(self,
+                      method: str = "RCM") -> None:
+        """**类方法 - reorder_nodes：**<br>
+         - 按局部性重排节点的内部索引，并重建快照
+
+        说明:
+            节点的内部索引默认按加入顺序分配，路网中相邻的节点在内存中可能相距很远。
+            重排后相邻节点的索引相近，最短路径搜索访问的数组更集中，缓存命中率更高。
+            只改变内部存储顺序，节点编号与计算结果不变。之后新加入的节点排在末尾，
+            大量修改图后可再次调用。
+            - "BFS"：各连通分量按广度优先顺序编号。
+            - "RCM"：逆 Cuthill-McKee 顺序，使相邻节点的索引差（带宽）尽量小。
+            - "Hilbert"：按 Hilbert 曲线上的坐标位置编号，需先调用 set_node_coords，无坐标的节点排在最后。
+
+        Args:
+            method (str): 重排方法，"BFS"、"RCM" 或 "Hilbert"，默认为 "RCM"。
+
+        Raises:
+            ValueError: 如果“method”不是上述取值之一。
+            RuntimeError: 如果使用 "Hilbert" 但未设置节点坐标。
+        """
+        if method not in ("BFS", "RCM", "Hilbert"):
+            raise ValueError(f"Invalid value for 'method': {method}. It must be 'BFS', 'RCM' or 'Hilbert'.")
+
+        self.graph.reorder_nodes(method)
+
+    def nearest_nodes(self,
+                      x: np.ndarray,
+                      y: np.ndarray,
+                      k: int = 1,
+                      num_thread: int = 1) -> dict:
+        """**类方法 - nearest_nodes：**<br>
+         - 批量查询距离每个坐标最近的 k 个节点（如 GPS 点吸附到路网节点）
+
+        说明:
+            基于节点坐标（set_node_coords）建立均匀网格索引，坐标或图修改后在下次查询时自动重建。
+            距离为坐标平面上的欧氏距离，经纬度坐标请先投影为平面坐标。形心点不参与查询。
+            查询期间释放 GIL，按查询分段多线程执行。
+
+        Args:
+            x (np.ndarray): 查询点 x 坐标，一维数值数组。
+            y (np.ndarray): 查询点 y 坐标，一维数值数组，长度与 x 相同。
+            k (int): 每个查询点返回的节点数，默认为 1。
+            num_thread (int): 线程数，默认为 1。
+
+        Raises:
+            ValueError: 如果“x”或“y”不是 numpy 数组，或“k”、“num_thread”不是正整数。
+            RuntimeError: 如果尚未设置节点坐标，坐标含 inf 或 NaN，或数组维度、长度、dtype 不符合要求。
+
+        Returns:
+            dict: 包含以下两项，形状均为 (len(x), k)，每行按距离升序：<br>
+                "node"：节点编号（int32），不足 k 个时以 -1 补齐；<br>
+                "distance"：距离（float64），不足 k 个时以 inf 补齐。
+        """
+        if 1:
+            for name, arr in (("x", x), ("y", y)):
+                if not isinstance(arr, np.ndarray):
+                    raise ValueError(f"Expected '{name}' to be a numpy.ndarray, but got {type(arr)}.")
+            if not isinstance(k, int) or k < 1:
+                raise ValueError(f"Invalid value for 'k': {k}. It must be a positive integer.")
+            if not isinstance(num_thread, int) or num_thread < 1:
+                raise ValueError(f"Invalid value for 'num_thread': {num_thread}. It must be a positive integer.")
+
+        return self.graph.nearest_nodes(x, y, k, num_thread)
+
+    def nearest_edges(self,
+                      x: np.ndarray,
+                      y: np.ndarray,
+                      radius: float,
+                      num_thread: int = 1) -> dict:
+        """**类方法 - nearest_edges：**<br>
+         - 批量查询每个坐标 radius 范围内的边及投影点（如地图匹配的候选边）
+
+        说明:
+            边视为两端节点坐标之间的线段，两端均有坐标且均不是形心点的边才参与查询；
+            双向道路的两个方向各作为一条边返回。距离为坐标平面上的欧氏距离。
+            查询期间释放 GIL，按查询分段多线程执行。
+
+        Args:
+            x (np.ndarray): 查询点 x 坐标，一维数值数组。
+            y (np.ndarray): 查询点 y 坐标，一维数值数组，长度与 x 相同。
+            radius (float): 搜索半径，有限非负数。
+            num_thread (int): 线程数，默认为 1。
+
+        Raises:
+            ValueError: 如果“x”或“y”不是 numpy 数组，“radius”不是有限非负数，或“num_thread”不是正整数。
+            RuntimeError: 如果尚未设置节点坐标，坐标含 inf 或 NaN，或数组维度、长度、dtype 不符合要求。
+
+        Returns:
+            dict: 平铺的匹配结果，各项为等长一维数组，按查询序号、再按距离升序排列：<br>
+                "query"：查询点序号；"start"、"end"：边的起点与终点编号；<br>
+                "x"、"y"：投影点坐标；"distance"：查询点到投影点的距离；<br>
+                "offset"：投影点沿边距起点的长度；"length"：边（线段）长度。
+        """
+        if 1:
+            for name, arr in (("x", x), ("y", y)):
+                if not isinstance(arr, np.ndarray):
+                    raise ValueError(f"Expected '{name}' to be a numpy.ndarray, but got {type(arr)}.")
+            if not isinstance(radius, (int, float)) or not np.isfinite(radius) or radius < 0:
+                raise ValueError(f"Invalid value for 'radius': {radius}. It must be a finite non-negative number.")
+            if not isinstance(num_thread, int) or num_thread < 1:
+                raise ValueError(f"Invalid value for 'num_thread': {num_thread}. It must be a positive integer.")
+
+        return self.graph.nearest_edges(x, y, float(radius), num_thread)
+
+    def contract_chains(self,
+                        enable: bool = True) -> None:
+        """**类方法 - contract_chains：**<br>
+         - 启用或关闭度为 2 的链收缩
+
+        说明:
+            路网中大量形状点只与前后两个节点相连（单向 p->x->q 或双向 p<->x<->q），
+            启用后这类链被收缩为两端之间的捷径边，各字段的捷径权重为链上各边权重之和，
+            路径搜索在收缩图上进行。multi_source_path、multi_multi_source_path、shortest_path_path、
+            k_shortest_paths 与 path_list_to_dict 返回的路径自动展开回原始节点，链内部节点的花费与路径一并补全。
+            起点或终点位于链内部时自动改用原图搜索。形心点及与形心边相连的节点不参与收缩。
+            图被修改后，收缩图在下次查询时重建（增量层先合并），适合静态路网。
+
+        Args:
+            enable (bool): True 启用并立即构建收缩图，False 关闭并释放收缩图，默认为 True。
+
+        Raises:
+            ValueError: 如果“enable”不是布尔值。
+        """
+        if not isinstance(enable, bool):
+            raise ValueError(f"Invalid value for 'enable': {enable}. It must be a boolean.")
+
+        self.graph.contract_chains(enable)
+
+    def build_landmarks(self,
+                        weight_name: str = None,
+                        num_landmarks: int = 16,
+                        selection: str = "avoid",
+                        num_thread: int = 1) -> None:
+        """**类方法 - build_landmarks：**<br>
+         - 为权重字段构建 ALT（A*、路标、三角不等式）路标索引
+
+        说明:
+            预先计算各路标到全部节点、全部节点到各路标的最短花费，查询时由三角不等式得到
+            到终点花费的下界，引导双向搜索朝终点扩展，不需要节点坐标。
+            shortest_path_cost / shortest_path_path / shortest_path_all 与 k_shortest_paths
+            传入 method="ALT" 时使用对应 weight_name 的索引。
+            每个权重字段各存一份索引（节点数 × 路标数 × 2 个花费）。图或任意边权重修改后，
+            索引在下次查询时按原参数重建。
+
+        Args:
+            weight_name (str): 权重字段名称。默认值为None。
+            num_landmarks (int): 路标数，默认为 16。
+            selection (str): 路标选择方法，默认为 "avoid"：<br>
+                -“farthest”：依次取距已选路标最远的节点。<br>
+                -“avoid”：优先覆盖现有路标下界偏差最大的区域，通常查询更快。
+            num_thread (int): 计算各路标花费的线程数，默认为 1。
+
+        Raises:
+            ValueError: 如果任何输入参数的类型或值无效。
+        """
+        if 1:
+            if weight_name is not None and not isinstance(weight_name, str):
+                raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
+            if not isinstance(num_landmarks, int) or num_landmarks < 1:
+                raise ValueError(f"Invalid value for 'num_landmarks': {num_landmarks}. It must be a positive integer.")
+            if selection not in ["farthest", "avoid"]:
+                raise ValueError(f"Invalid value for 'selection': {selection}. It must be 'farthest' or 'avoid'.")
+            if not isinstance(num_thread, int) or num_thread < 1:
+                raise ValueError(f"Invalid value for 'num_thread': {num_thread}. It must be a positive integer.")
+
+        if weight_name is None:
+            weight_name = ""
+        self.graph.build_landmarks(weight_name, num_landmarks, selection, num_thread)
+
+    def build_ch(self,
+                 weight_name: str = None) -> None:
+        """**类方法 - build_ch：**<br>
+         - 为权重字段构建收缩层次（Contraction Hierarchies）
+
+        说明:
+            按「新增捷径数 - 删除边数 + 已收缩邻点数」的优先级依次收缩节点，收缩时以见证搜索判断
+            邻点之间是否需要捷径。查询只沿 rank 升高的方向双向搜索，找到后将捷径展开为原图路径，
+            花费沿原图路径累加，与 Dijkstra 结果相同（等长路径并存时可能返回其中另一条）。
+            shortest_path_cost / shortest_path_path / shortest_path_all 传入 method="CH" 时使用。
+            每个权重字段各存一份，图或任意边权重修改后在下次查询时重建，适合静态路网与高频查询。
+
+        Args:
+            weight_name (str): 权重字段名称。默认值为None。
+
+        Raises:
+            ValueError: 如果“weight_name”不是字符串或 None。
+        """
+        if weight_name is not None and not isinstance(weight_name, str):
+            raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
+
+        if weight_name is None:
+            weight_name = ""
+        self.graph.build_ch(weight_name)
+
+    def build_overlay(self,
+                      cell_size: int = 128,
+                      num_levels: int = 4,
+                      fanout: int = 8) -> None:
+        """**类方法 - build_overlay：**<br>
+         - 构建 CRP（Customizable Route Planning）多层分区覆盖图
+
+        说明:
+            按拓扑逐层区域生长划分嵌套单元：第 1 层单元至多 cell_size 个节点，每升一层上限乘以 fanout，
+            并记录各单元的入口与出口节点。这一步与权重无关，只在图的拓扑修改后需要重做（下次查询时自动按原参数重建）。
+            构建后需调用 customize_overlay 为权重字段计算团花费，之后
+            shortest_path_cost / shortest_path_path / shortest_path_all 传入 method="CRP"、
+            multi_single_source_cost_targets 传入 method="CRP" 时在覆盖图上查询。
+            重新构建后，已定制的权重字段在下次查询时按新分区重新定制。
+
+        Args:
+            cell_size (int): 第 1 层单元节点数上限，默认为 128，至少为 2。
+            num_levels (int): 层数，默认为 4（单元无法继续合并时实际层数更少）。
+            fanout (int): 每升一层单元节点数上限的倍数，默认为 8，至少为 2。
+
+        Raises:
+            ValueError: 如果任何输入参数的类型或值无效。
+        """
+        if 1:
+            if not isinstance(cell_size, int) or cell_size < 2:
+                raise ValueError(f"Invalid value for 'cell_size': {cell_size}. It must be an integer >= 2.")
+            if not isinstance(num_levels, int) or num_levels < 1:
+                raise ValueError(f"Invalid value for 'num_levels': {num_levels}. It must be a positive integer.")
+            if not isinstance(fanout, int) or fanout < 2:
+                raise ValueError(f"Invalid value for 'fanout': {fanout}. It must be an integer >= 2.")
+
+        self.graph.build_overlay(cell_size, num_levels, fanout)
+
+    def customize_overlay(self,
+                          weight_name: str = None,
+                          num_thread: int = 1) -> None:
+        """**类方法 - customize_overlay：**<br>
+         - 按权重字段定制 CRP 覆盖图的团花费
+
+        说明:
+            自底向上逐层计算每个单元内各入口到各出口只经单元内节点的最短花费，同层单元并行计算。
+            权重字段可以是任意边属性；权重更新（如 update_edge_weights 刷新实时路况）后重新调用即可，
+            无需重建分区。未重新调用时，图或权重修改后的下次查询也会按原线程数自动重新定制。
+            每个权重字段各存一份团花费。
+
+        Args:
+            weight_name (str): 权重字段名称。默认值为None。
+            num_thread (int): 并行定制的线程数，默认为 1。
+
+        Raises:
+            ValueError: 如果任何输入参数的类型或值无效。
+        """
+        if 1:
+            if weight_name is not None and not isinstance(weight_name, str):
+                raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
+            if not isinstance(num_thread, int) or num_thread < 1:
+                raise ValueError(f"Invalid value for 'num_thread': {num_thread}. It must be a positive integer.")
+
+        if weight_name is None:
+            weight_name = ""
+        self.graph.customize_overlay(weight_name, num_thread)
+
+    def update_edge_weights(self,
+                            u: np.ndarray,
+                            v: np.ndarray,
+                            values: np.ndarray,
+                            field: str) -> int:
+        """**类方法 - update_edge_weights：**<br>
+         - 批量原地修改已有边的某个属性（如实时路况的通行时间）
+
+        说明:
+            每条边按哈希邻接 O(1) 定位，属性列与已缓存的正反向权重列同步更新，
+            不改变拓扑、不重建快照，适合在两次查询之间调用（不可与查询并发）。
+            不存在的边和值为 NaN 的项被跳过。
+
+        Args:
+            u (np.ndarray): 边的起始节点，一维 int32/int64 数组。
+            v (np.ndarray): 边的结束节点，一维 int32/int64 数组，长度与 u 相同。
+            values (np.ndarray): 新的属性值，一维数值数组，长度与 u 相同。
+            field (str): 要修改的属性字段名。
+
+        Raises:
+            ValueError: 如果“u”、“v”或“values”不是 numpy 数组，或“field”不是字符串。
+            RuntimeError: 如果数组维度、长度或 dtype 不符合要求，或节点编号超出 int32 范围（在 C++ 中统一校验）。
+
+        Returns:
+            int: 实际更新的边数。
+        """
+        if 1:
+            # 只检查容器类型，dtype 与长度在 C++ 中一次性校验
+            for name, arr in (("u", u), ("v", v), ("values", values)):
+                if not isinstance(arr, np.ndarray):
+                    raise ValueError(f"Expected '{name}' to be a numpy.ndarray, but got {type(arr)}.")
+            if not isinstance(field, str):
+                raise ValueError(f"Invalid value for 'field': {field}. It must be a string.")
+
+        return self.graph.update_edge_weights(u, v, values, field)
+
+    def save(self,
+             path: str) -> None:
+        """**类方法 - save：**<br>
+         - 将图保存为二进制图像文件（拓扑、边属性列、形心点标记、节点编号映射）
+
+        Args:
+            path (str): 图像文件路径。
+
+        Raises:
+            ValueError: 如果“path”不是字符串。
+            RuntimeError: 如果文件无法写入。
+        """
+        if not isinstance(path, str):
+            raise ValueError(f"Invalid value for 'path': {path}. It must be a string.")
+
+        self.graph.save(path)
+
+    def load(self,
+             path: str) -> None:
+        """**类方法 - load：**<br>
+         - 以内存映射方式加载图像文件，替换当前图
+
+        说明:
+            快照数组直接指向映射的文件，不做解析，加载耗时接近缺页开销；
+            首次修改图（加边、删边、设形心点）或查询点/边信息时才重建可变结构。
+            加载期间请勿改写该文件。
+
+        Args:
+            path (str): 由 save 写出的图像文件路径。
+
+        Raises:
+            ValueError: 如果“path”不是字符串。
+            RuntimeError: 如果文件不存在、版本不符或内容损坏。
+        """
+        if not isinstance(path, str):
+            raise ValueError(f"Invalid value for 'path': {path}. It must be a string.")
+
+        self.graph.load(path)
+
+    def publish_shared(self,
+                       name: str) -> None:
+        """**类方法 - publish_shared：**<br>
+         - 将图发布到具名共享内存段，供其他进程以 attach_shared 只读挂接
+
+        说明:
+            段内容与 save 写出的图像文件相同；同名段已存在时被替换（已挂接的进程不受影响）。
+            Linux 下段会一直保留到 unlink_shared；Windows 下随最后一个挂接进程退出而释放，
+            发布进程需保持存活。
+
+        Args:
+            name (str): 共享内存段名称。
+
+        Raises:
+            ValueError: 如果“name”不是字符串。
+            RuntimeError: 如果共享内存无法创建。
+        """
+        if not isinstance(name, str):
+            raise ValueError(f"Invalid value for 'name': {name}. It must be a string.")
+
+        self.graph.publish_shared(name)
+
+    def attach_shared(self,
+                      name: str) -> None:
+        """**类方法 - attach_shared：**<br>
+         - 挂接其他进程发布的具名共享内存段，替换当前图
+
+        说明:
+            快照数组直接指向共享内存，不复制，多个工作进程共用同一份物理内存。
+            挂接后修改图会在本进程内重建私有副本，不影响共享段和其他进程。
+
+        Args:
+            name (str): publish_shared 使用的共享内存段名称。
+
+        Raises:
+            ValueError: 如果“name”不是字符串。
+            RuntimeError: 如果共享内存段不存在或内容损坏。
+
+        Example:
+            # 主进程
+            g.publish_shared("road_net")
+            # 工作进程
+            worker = graphworkc.CGraph()
+            worker.attach_shared("road_net")
+        """
+        if not isinstance(name, str):
+            raise ValueError(f"Invalid value for 'name': {name}. It must be a string.")
+
+        self.graph.attach_shared(name)
+
+    @staticmethod
+    def unlink_shared(name: str) -> None:
+        """**静态方法 - unlink_shared：**<br>
+         - 删除具名共享内存段（已挂接的进程不受影响，全部退出后内存释放）
+
+        Args:
+            name (str): 共享内存段名称。
+        """
+        if not isinstance(name, str):
+            raise ValueError(f"Invalid value for 'name': {name}. It must be a string.")
+
+        graphwork.GraphAlgorithms.unlink_shared(name)
+
     def multi_source_cost(self,
                           start_nodes: list[int],
                           method: str = "Dijkstra",
@@ -253,6 +800,9 @@ class CGraph:
               start_nodes (list): 多源最短路径计算的起始节点列表。列表中的每个元素代表一个起点节点。
               method (str): 用于计算最短路径的算法。它可以是以下之一：
                   -“Dijkstra”：标准Dijkstra算法。
+                  -“Dijkstra-4ary”：索引4叉堆（decrease-key）的Dijkstra算法。
+                  -“Dijkstra-radix”：基数堆的Dijkstra算法。
+                  -“Dijkstra-dial”：桶队列的Dijkstra算法，适合小整数权重。
                   默认为“Dijkstra”。
               target (int): 最短路径计算的目标节点。如果设置为-1，则表示没有特定目标。
               cut_off (float): 最短路径的最大距离限制。任何超过此值的路径都将被忽略。
@@ -264,7 +814,7 @@ class CGraph:
           Raises:
               ValueError: 如果违反了以下任何一项：<br>
                   -“start_nodes”不是列表。<br>
-                  -“method”不是有效的算法之一：“Dijkstra”。<br>
+                  -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                   -“target”不是整数。<br>
                   -“cut_off”不是非负数。<br>
                   -“weight_name”不是字符串。
@@ -275,7 +825,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -310,6 +860,9 @@ class CGraph:
             start_nodes (list[int]): 多源最短路径计算的起始节点列表。列表中的每个元素代表一个起点节点。
             method (str): 用于计算最短路径的算法。它可以是以下之一：
                 -“Dijkstra”：标准Dijkstra算法。
+                -“Dijkstra-4ary”：索引4叉堆（decrease-key）的Dijkstra算法。
+                -“Dijkstra-radix”：基数堆的Dijkstra算法。
+                -“Dijkstra-dial”：桶队列的Dijkstra算法，适合小整数权重。
                 默认为“Dijkstra”。
             target (int): 最短路径计算的目标节点。如果设置为-1，则表示没有特定目标。
             cut_off (float): 最短路径的最大距离限制。任何超过此值的路径都将被忽略。
@@ -321,7 +874,7 @@ class CGraph:
         Raises:
             ValueError: 如果违反了以下任何一项：<br>
                 -“start_nodes”不是列表。<br>
-                -“method”不是有效的算法之一：“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”不是整数。<br>
                 -“cut_off”不是非负数。<br>
                 -“weight_name”不是字符串。
@@ -332,7 +885,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -367,6 +920,9 @@ class CGraph:
             start_nodes (list[int]): 多源最短路径计算的起始节点列表。列表中的每个元素代表一个起点节点。
             method (str): 用于计算最短路径的算法。它可以是以下之一：
                 -“Dijkstra”：标准Dijkstra算法。
+                -“Dijkstra-4ary”：索引4叉堆（decrease-key）的Dijkstra算法。
+                -“Dijkstra-radix”：基数堆的Dijkstra算法。
+                -“Dijkstra-dial”：桶队列的Dijkstra算法，适合小整数权重。
                 默认为“Dijkstra”。
             target (int): 最短路径计算的目标节点。如果设置为-1，则表示没有特定目标。
             cut_off (float): 最短路径的最大距离限制。任何超过此值的路径都将被忽略。
@@ -381,7 +937,7 @@ class CGraph:
         Raises:
             ValueError: 如果违反了以下任何一项：<br>
                 -“start_nodes”不是列表。<br>
-                -“method”不是有效的算法之一：“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”不是整数。<br>
                 -“cut_off”不是非负数。<br>
                 -“weight_name”不是字符串。
@@ -392,7 +948,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -426,6 +982,9 @@ class CGraph:
             start (int): 多源最短路径计算的起始节点。
             method (str): 用于计算最短路径的算法。它可以是以下之一：
                 -“Dijkstra”：标准Dijkstra算法。
+                -“Dijkstra-4ary”：索引4叉堆（decrease-key）的Dijkstra算法。
+                -“Dijkstra-radix”：基数堆的Dijkstra算法。
+                -“Dijkstra-dial”：桶队列的Dijkstra算法，适合小整数权重。
                 默认为“Dijkstra”。
             target (int): 最短路径计算的目标节点。如果设置为-1，则表示没有特定目标。
             cut_off (float): 最短路径的最大距离限制。任何超过此值的路径都将被忽略。
@@ -437,7 +996,7 @@ class CGraph:
         Raises:
             ValueError: 如果违反了以下任何一项：<br>
                 -“start”不是整数。<br>
-                -“method”不是有效的算法之一：“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”不是整数。<br>
                 -“cut_off”不是非负数。<br>
                 -“weight_name”不是字符串。
@@ -448,7 +1007,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start': {start}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -483,6 +1042,9 @@ class CGraph:
             start (int): 多源最短路径计算的起始节点。
             method (str): 用于计算最短路径的算法。它可以是以下之一：
                 -“Dijkstra”：标准Dijkstra算法。
+                -“Dijkstra-4ary”：索引4叉堆（decrease-key）的Dijkstra算法。
+                -“Dijkstra-radix”：基数堆的Dijkstra算法。
+                -“Dijkstra-dial”：桶队列的Dijkstra算法，适合小整数权重。
                 默认为“Dijkstra”。
             target (int): 最短路径计算的目标节点。如果设置为-1，则表示没有特定目标。
             cut_off (float): 最短路径的最大距离限制。任何超过此值的路径都将被忽略。
@@ -494,7 +1056,7 @@ class CGraph:
         Raises:
             ValueError: 如果违反了以下任何一项：<br>
                 -“start”不是整数。<br>
-                -“method”不是有效的算法之一：“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”不是整数。<br>
                 -“cut_off”不是非负数。<br>
                 -“weight_name”不是字符串。
@@ -505,7 +1067,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start': {start}. It must be a int.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -540,6 +1102,9 @@ class CGraph:
             start (int): 单源最短路径计算的起始节点。
             method (str): 用于计算最短路径的算法。它可以是以下之一：
                 -“Dijkstra”：标准Dijkstra算法。
+                -“Dijkstra-4ary”：索引4叉堆（decrease-key）的Dijkstra算法。
+                -“Dijkstra-radix”：基数堆的Dijkstra算法。
+                -“Dijkstra-dial”：桶队列的Dijkstra算法，适合小整数权重。
                 默认为“Dijkstra”。
             target (int): 最短路径计算的目标节点。如果设置为-1，则表示没有特定目标。
             cut_off (float): 最短路径的最大距离限制。任何超过此值的路径都将被忽略。
@@ -554,7 +1119,7 @@ class CGraph:
         Raises:
             ValueError: 如果违反了以下任何一项：<br>
                 -“start”不是整数。<br>
-                -“method”不是有效的算法之一：“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”不是整数。<br>
                 -“cut_off”不是非负数。<br>
                 -“weight_name”不是字符串。
@@ -565,7 +1130,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start': {start}. It must be a int.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -600,7 +1165,7 @@ class CGraph:
 
         Args:
             start_nodes (list): 路径搜索的起始节点列表。每个项目列表中的值必须是整数。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）、“PHAST”（收缩层次上的一到全部扫描，需先调用 build_ch，target 不起作用）。默认为“Dijkstra”。
             target (int): 要到达的目标节点。如果-1，则查找所有节点的路径。必须是非负整数。
             cut_off (float): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
@@ -608,12 +1173,12 @@ class CGraph:
 
         Returns:
             list[dict[int, float]]: 返回多个单源最短路径计算的路径结果<br>
-                                列表内的元素是每个源节点的单源最短计算花费字典dict[int, float]
+                                列表内的元素是每个源节点的单源最短计算花费字典dict[int, float]，不在图中的起点对应空字典
 
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”、“PHAST”。<br>
                 -“target”必须是非负整数。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
@@ -625,7 +1190,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS + ["PHAST"]
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -652,6 +1217,70 @@ class CGraph:
 
         return result
 
+    def multi_single_source_cost_targets(self,
+                         start_nodes: list[int],
+                         targets: list[int],
+                         method: str = "Dijkstra",
+                         cut_off: float = float('inf'),
+                         weight_name: str = None,
+                         num_thread: int = 1) -> list[dict[int, float]]:
+        """**类方法 - multi_single_source_cost_targets：**<br>
+         - 多个单源到目标集的最短花费，返回花费列表
+
+        Args:
+            start_nodes (list[int]): 路径搜索的起始节点列表。每个项目列表中的值必须是整数。
+            targets (list): 目标节点列表。每个起点的搜索在全部目标确定（或超过cut_off）后即停止。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）、“CRP”（多层覆盖图，需先调用 build_overlay 与 customize_overlay）。默认为“Dijkstra”。
+            cut_off (float): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
+            weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
+            num_thread (int): 用于并行计算的线程数。默认值为1。必须是整数。
+
+        Returns:
+            list[dict[int, float]]: 列表内的元素依次为每个起点到各目标的花费字典dict[int, float]，不在图中的起点对应空字典<br>
+                                字典只包含cut_off以内可达的目标节点
+
+        Raises:
+            ValueError: 如果任何输入参数的类型或值无效：<br>
+                -“start_nodes”必须是整数列表。<br>
+                -“targets”必须是整数列表。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”、“CRP”。<br>
+                -“cut_off”必须是非负数。<br>
+                -“weight_name”必须是字符串。<br>
+                -“num_thread”必须是整数。
+        """
+        if 1:
+            # 检查 start_nodes 是否是一个列表
+            if not isinstance(start_nodes, list):
+                raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
+
+            # 检查 targets 是否是一个整数列表
+            if not isinstance(targets, list) or not all(isinstance(t, int) for t in targets):
+                raise ValueError(f"Invalid value for 'targets': {targets}. It must be a list of integers.")
+
+            # 检查 method 是否是有效的字符串
+            valid_methods = DIJKSTRA_METHODS + ["CRP"]
+            if method not in valid_methods:
+                raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
+
+            # 检查 cut_off 是否是一个非负浮动数
+            if not isinstance(cut_off, (int, float)) or cut_off < 0:
+                raise ValueError(f"Invalid value for 'cut_off': {cut_off}. It must be a non-negative number.")
+
+            # 检查 weight_name 是否是一个字符串或 None
+            if weight_name is not None and not isinstance(weight_name, str):
+                raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
+
+            # 检查 num_thread 是否是一个整数
+            if not isinstance(num_thread, int):
+                raise ValueError(f"Invalid value for 'num_thread': {num_thread}. It must be a integer.")
+
+        # 如果 weight_name 是 None, 不传递该参数
+        if weight_name is None:
+            weight_name = ""
+        result = self.graph.multi_single_source_cost_targets(start_nodes, targets, method, cut_off, weight_name, num_thread)
+
+        return result
+
     def multi_single_source_path(self,
                          start_nodes: list[int],
                          method: str = "Dijkstra",
@@ -664,7 +1293,7 @@ class CGraph:
 
         Args:
             start_nodes (list): 路径搜索的起始节点列表。每个项目列表中的值必须是整数。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
             target (int): 要到达的目标节点。如果-1，则查找所有节点的路径。必须是非负整数。
             cut_off (float): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
@@ -672,12 +1301,12 @@ class CGraph:
 
         Returns:
             list[dict[int, list[int]]]: 返回多个单源最短路径计算的路径结果<br>
-                                        列表内的每个元素是每个源节点的单源最短路径dict[int, list[int]]
+                                        列表内的每个元素是每个源节点的单源最短路径dict[int, list[int]]，不在图中的起点对应空字典
 
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”必须是非负整数。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
@@ -689,7 +1318,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -727,14 +1356,14 @@ class CGraph:
 
         Args:
             start_nodes (list): 路径搜索的起始节点列表。每个项目列表中的值必须是整数。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
             target (int): 要到达的目标节点。如果-1，则查找所有节点的路径。必须是非负整数。
             cut_off (float or int): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
             num_thread (int): 用于并行计算的线程数。默认值为1。必须是整数。
 
         Returns:
-            dict: 返回多个单源最短路径计算的路径结果，二维列表：元素是每个源节点的结构体dis_and_path,此结构体包含两个属性{cost,paths} <br>
+            dict: 返回多个单源最短路径计算的路径结果，二维列表：元素是每个源节点的结构体dis_and_path,此结构体包含两个属性{cost,paths}，不在图中的起点两个属性均为空 <br>
                     假设返回结果为： res_list，则 <br>
                           结果的第k个元素：res_list[k]: <br>
                           res_list[k].cost为 dict[int, float]: 单源最短路径计算的花费结果，键为目标节点，值为对应的花费 <br>
@@ -743,7 +1372,7 @@ class CGraph:
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”必须是非负整数。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
@@ -755,7 +1384,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'list_o': {start_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -793,7 +1422,7 @@ class CGraph:
 
         Args:
             start_nodes (list): 路径搜索的起始节点二维列表。每个列表中的列表是一个多源节点列表。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
             target (int): 要到达的目标节点。如果-1，则查找所有节点的路径。必须是非负整数。
             cut_off (float or int): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
@@ -806,7 +1435,7 @@ class CGraph:
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是二维整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”必须是非负整数。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
@@ -822,7 +1451,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list of lists.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -860,7 +1489,7 @@ class CGraph:
 
         Args:
             start_nodes (list): 路径搜索的起始节点二维列表。每个列表中的列表是一个多源节点列表。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
             target (int): 要到达的目标节点。如果-1，则查找所有节点的路径。必须是非负整数。
             cut_off (float or int): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
@@ -873,7 +1502,7 @@ class CGraph:
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是二维整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”必须是非负整数。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
@@ -889,7 +1518,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list of lists.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -927,7 +1556,7 @@ class CGraph:
 
         Args:
             start_nodes (list): 路径搜索的起始节点二维列表。每个列表中的列表是一个多源节点列表。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
             target (int): 要到达的目标节点。如果-1，则查找所有节点的路径。必须是非负整数。
             cut_off (float or int): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
@@ -944,7 +1573,7 @@ class CGraph:
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是二维整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“target”必须是非负整数。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
@@ -960,7 +1589,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list of lists.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -986,6 +1615,70 @@ class CGraph:
 
         return result
 
+    def multi_multi_source_cost_targets(self,
+                         start_nodes: list[list[int]],
+                         targets: list[int],
+                         method: str = "Dijkstra",
+                         cut_off: float = float('inf'),
+                         weight_name: str = None,
+                         num_thread: int = 1) -> list[dict[int, float]]:
+        """**类方法 - multi_multi_source_cost_targets：**<br>
+         - 多个多源到目标集的最短花费，返回花费列表
+
+        Args:
+            start_nodes (list[list[int]]): 多组源节点列表，每组为一个多源搜索的起点列表。
+            targets (list): 目标节点列表。每个起点的搜索在全部目标确定（或超过cut_off）后即停止。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
+            cut_off (float): 要搜索的最大距离。如果其总权重超过该值,路径被丢弃。默认值为无穷大。
+            weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
+            num_thread (int): 用于并行计算的线程数。默认值为1。必须是整数。
+
+        Returns:
+            list[dict[int, float]]: 列表内的元素依次为每组源节点到各目标的花费字典dict[int, float]<br>
+                                字典只包含cut_off以内可达的目标节点
+
+        Raises:
+            ValueError: 如果任何输入参数的类型或值无效：<br>
+                -“start_nodes”必须是整数列表的列表。<br>
+                -“targets”必须是整数列表。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
+                -“cut_off”必须是非负数。<br>
+                -“weight_name”必须是字符串。<br>
+                -“num_thread”必须是整数。
+        """
+        if 1:
+            # 检查 start_nodes 是否是一个列表
+            if not isinstance(start_nodes, list):
+                raise ValueError(f"Invalid value for 'start_nodes': {start_nodes}. It must be a list.")
+
+            # 检查 targets 是否是一个整数列表
+            if not isinstance(targets, list) or not all(isinstance(t, int) for t in targets):
+                raise ValueError(f"Invalid value for 'targets': {targets}. It must be a list of integers.")
+
+            # 检查 method 是否是有效的字符串
+            valid_methods = DIJKSTRA_METHODS
+            if method not in valid_methods:
+                raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
+
+            # 检查 cut_off 是否是一个非负浮动数
+            if not isinstance(cut_off, (int, float)) or cut_off < 0:
+                raise ValueError(f"Invalid value for 'cut_off': {cut_off}. It must be a non-negative number.")
+
+            # 检查 weight_name 是否是一个字符串或 None
+            if weight_name is not None and not isinstance(weight_name, str):
+                raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
+
+            # 检查 num_thread 是否是一个整数
+            if not isinstance(num_thread, int):
+                raise ValueError(f"Invalid value for 'num_thread': {num_thread}. It must be a integer.")
+
+        # 如果 weight_name 是 None, 不传递该参数
+        if weight_name is None:
+            weight_name = ""
+        result = self.graph.multi_multi_source_cost_targets(start_nodes, targets, method, cut_off, weight_name, num_thread)
+
+        return result
+
     def cost_matrix_to_numpy(self,
                              start_nodes: list[int],
                              end_nodes: list[int],
@@ -999,7 +1692,7 @@ class CGraph:
         Args:
             start_nodes (list of ints): 路径搜索的起始节点列表。每个元素都应该可以是表示单个起始节点的整数。
             end_nodes (list of ints): 路径搜索的结束节点列表。每个元素都应该。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）、“CH”（收缩层次上的多对多桶算法，需先调用 build_ch）。默认为“Dijkstra”。
             cut_off (float or int): 要搜索的最大距离。路径被丢弃如果其总重量超过该值。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
             num_thread (int): 用于并行计算的线程数。默认值为1。必须是整数。
@@ -1008,13 +1701,13 @@ class CGraph:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是整数列表。<br>
                 -“end_nodes”必须是整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”、“CH”。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
                 -“num_thread”必须是整数。
 
         Returns:
-            numpy.ndarray: 一个numpy数组，其中每个元素表示最短路径成本<br>
+            numpy.ndarray: 一个numpy数组，其中每个元素表示最短路径成本（以紧凑模式编译时为 float32）<br>
                 数组的维度将是len（start_nodes）x len（end_nodes”）<br>
                 假设返回结果是res： 则<br>
                 res[m][n]代表了从m到n的花费
@@ -1029,7 +1722,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'end_nodes': {end_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS + ["CH"]
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -1064,7 +1757,7 @@ class CGraph:
         Args:
             start_nodes (list of ints): 路径搜索的起始节点列表。每个元素都应该可以是表示单个起始节点的整数。
             end_nodes (list of ints): 路径搜索的结束节点列表。每个元素都应该。
-            method (str): 用于寻路的算法。有效选项为“Dijkstra”。默认为“Dijkstra”。
+            method (str): 用于寻路的算法。有效选项为“Dijkstra”、“Dijkstra-4ary”（索引4叉堆）、“Dijkstra-radix”（基数堆）、“Dijkstra-dial”（桶队列）。默认为“Dijkstra”。
             cut_off (float or int): 要搜索的最大距离。路径被丢弃如果其总重量超过该值。默认值为无穷大。
             weight_name (str): 用作寻路权重的边属性的名称算法。默认值为“无”。
             num_thread (int): 用于并行计算的线程数。默认值为1。必须是整数。
@@ -1073,7 +1766,7 @@ class CGraph:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                 -“start_nodes”必须是整数列表。<br>
                 -“end_nodes”必须是整数列表。<br>
-                -“method”必须是“Dijkstra”。<br>
+                -“method”不是有效的算法之一：“Dijkstra”、“Dijkstra-4ary”、“Dijkstra-radix”、“Dijkstra-dial”。<br>
                 -“cut_off”必须是非负数。<br>
                 -“weight_name”必须是字符串。<br>
                 -“num_thread”必须是整数。
@@ -1093,7 +1786,7 @@ class CGraph:
                 raise ValueError(f"Invalid value for 'end_nodes': {end_nodes}. It must be a list.")
 
             # 检查 method 是否是有效的字符串
-            valid_methods = ["Dijkstra"]  # 你可以根据实际情况修改
+            valid_methods = DIJKSTRA_METHODS
             if method not in valid_methods:
                 raise ValueError(f"Invalid value for 'method': {method}. It must be one of {valid_methods}.")
 
@@ -1119,7 +1812,8 @@ class CGraph:
                        source: int,
                        target: int,
                        num: int,
-                       weight_name: str = None) -> list[list[int]]:
+                       weight_name: str = None,
+                       method: str = "Dijkstra") -> list[list[int]]:
         """**类方法 - k_shortest_paths：**
         - - 输入起点和目标点，和要获取的最短路数量，获得花费从小到大的最短路径序列
 
@@ -1128,6 +1822,7 @@ class CGraph:
             target (int): 路径搜索的终点。
             num (int): 要获取最短路径的数量。
             weight_name (str): 要使用的权重的字段名称。默认值为None。
+            method (str): 首条路径与各偏离路径的搜索方法，"Dijkstra"（双向Dijkstra）或 "ALT"（需先调用 build_landmarks），默认值为"Dijkstra"。
 
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
@@ -1135,6 +1830,7 @@ class CGraph:
                 -“target”必须是整数。<br>
                 -“num”必须是整数。<br>
                 -“weight_name”必须是字符串。<br>
+                -“method”必须是 "Dijkstra" 或 "ALT"。<br>
 
         Returns:
             list[list[int]]: 二维列表，按花费从小到大返回序列路径。 例如：<br>
@@ -1159,16 +1855,22 @@ class CGraph:
             if weight_name is not None and not isinstance(weight_name, str):
                 raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
 
+            # 检查 method 是否有效
+            if method not in ["Dijkstra", "ALT"]:
+                raise ValueError(f"Invalid value for 'method': {method}. It must be 'Dijkstra' or 'ALT'.")
+
         if weight_name is None:
             weight_name = ""
-        result = self.graph.k_shortest_paths(source, target, num, weight_name)
+        result = self.graph.k_shortest_paths(source, target, num, weight_name, method)
 
         return result
 
     def shortest_path_cost(self,
                        source: int,
                        target: int,
-                       weight_name: str = None) -> float:
+                       weight_name: str = None,
+                       method: str = "Dijkstra",
+                       max_speed: float = 1.0) -> float:
         """**类方法 - shortest_path_cost：**
         - - 输入起点和目标点，和要获取的最短路数量，获得花费从小到大的最短路径序列
 
@@ -1176,12 +1878,23 @@ class CGraph:
            source (int): 路径搜索的起点。
            target (int): 路径搜索的终点。
            weight_name (str): 要使用的权重的字段名称。默认值为None。
+           method (str): 点到点搜索算法，默认值为"Dijkstra"。它可以是以下之一：<br>
+              -“Dijkstra”：双向Dijkstra算法。<br>
+              -“AStar”：A*算法，以到终点的直线距离 / max_speed 为启发值。<br>
+              -“BiAStar”：双向A*算法。<br>
+              -“ALT”：以路标下界导向的双向搜索，需先调用 build_landmarks 为该 weight_name 构建索引。<br>
+              -“CH”：收缩层次上的双向搜索，需先调用 build_ch 为该 weight_name 构建收缩层次。<br>
+              -“CRP”：多层覆盖图上的搜索，需先调用 build_overlay 与 customize_overlay 为该 weight_name 定制团花费。<br>
+              A*需先调用 set_node_coords 为全部节点（形心点除外）设置坐标。
+           max_speed (float): 速度上界，须满足每条边的权重不小于其两端直线距离 / max_speed，否则结果可能不是最短路。默认值为1.0。
 
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                -“source”必须是整数。<br>
                -“target”必须是整数。<br>
                -“weight_name”必须是字符串。<br>
+               -“method”必须是 POINT_TO_POINT_METHODS 之一。<br>
+               -“max_speed”必须是正数。<br>
 
         Returns:
             double: 最短路径到达目标节点的花费。 例如：<br>
@@ -1200,16 +1913,26 @@ class CGraph:
             if weight_name is not None and not isinstance(weight_name, str):
                 raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
 
+            # 检查 method 是否有效
+            if method not in POINT_TO_POINT_METHODS:
+                raise ValueError(f"Invalid value for 'method': {method}. It must be one of {POINT_TO_POINT_METHODS}.")
+
+            # 检查 max_speed 是否为正数
+            if not isinstance(max_speed, (int, float)) or max_speed <= 0:
+                raise ValueError(f"Invalid value for 'max_speed': {max_speed}. It must be a positive number.")
+
         if weight_name is None:
             weight_name = ""
-        result = self.graph.shortest_path_cost(source, target, weight_name)
+        result = self.graph.shortest_path_cost(source, target, weight_name, method, float(max_speed))
 
         return result
 
     def shortest_path_path(self,
                        source: int,
                        target: int,
-                       weight_name: str = None) -> list[int]:
+                       weight_name: str = None,
+                       method: str = "Dijkstra",
+                       max_speed: float = 1.0) -> list[int]:
         """**类方法 - shortest_path_path：**
         - - 输入起点和目标点，和要获取的最短路数量，获得花费从小到大的最短路径序列
 
@@ -1217,12 +1940,23 @@ class CGraph:
            source (int): 路径搜索的起点。
            target (int): 路径搜索的终点。
            weight_name (str): 要使用的权重的字段名称。默认值为None。
+           method (str): 点到点搜索算法，默认值为"Dijkstra"。它可以是以下之一：<br>
+              -“Dijkstra”：双向Dijkstra算法。<br>
+              -“AStar”：A*算法，以到终点的直线距离 / max_speed 为启发值。<br>
+              -“BiAStar”：双向A*算法。<br>
+              -“ALT”：以路标下界导向的双向搜索，需先调用 build_landmarks 为该 weight_name 构建索引。<br>
+              -“CH”：收缩层次上的双向搜索，需先调用 build_ch 为该 weight_name 构建收缩层次。<br>
+              -“CRP”：多层覆盖图上的搜索，需先调用 build_overlay 与 customize_overlay 为该 weight_name 定制团花费。<br>
+              A*需先调用 set_node_coords 为全部节点（形心点除外）设置坐标。
+           max_speed (float): 速度上界，须满足每条边的权重不小于其两端直线距离 / max_speed，否则结果可能不是最短路。默认值为1.0。
 
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                -“source”必须是整数。<br>
                -“target”必须是整数。<br>
                -“weight_name”必须是字符串。<br>
+               -“method”必须是 POINT_TO_POINT_METHODS 之一。<br>
+               -“max_speed”必须是正数。<br>
 
         Returns:
             list[int]: 最短路径到达目标节点的路径。 例如：<br>
@@ -1241,16 +1975,26 @@ class CGraph:
             if weight_name is not None and not isinstance(weight_name, str):
                 raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
 
+            # 检查 method 是否有效
+            if method not in POINT_TO_POINT_METHODS:
+                raise ValueError(f"Invalid value for 'method': {method}. It must be one of {POINT_TO_POINT_METHODS}.")
+
+            # 检查 max_speed 是否为正数
+            if not isinstance(max_speed, (int, float)) or max_speed <= 0:
+                raise ValueError(f"Invalid value for 'max_speed': {max_speed}. It must be a positive number.")
+
         if weight_name is None:
             weight_name = ""
-        result = self.graph.shortest_path_path(source, target, weight_name)
+        result = self.graph.shortest_path_path(source, target, weight_name, method, float(max_speed))
 
         return result
 
     def shortest_path_all(self,
                        source: int,
                        target: int,
-                       weight_name: str = None) -> tuple[float, list[int]]:
+                       weight_name: str = None,
+                       method: str = "Dijkstra",
+                       max_speed: float = 1.0) -> tuple[float, list[int]]:
         """**类方法 - shortest_path_all：**
         - - 输入起点和目标点，和要获取的最短路数量，获得花费从小到大的最短路径序列
 
@@ -1258,12 +2002,23 @@ class CGraph:
            source (int): 路径搜索的起点。
            target (int): 路径搜索的终点。
            weight_name (str): 要使用的权重的字段名称。默认值为None。
+           method (str): 点到点搜索算法，默认值为"Dijkstra"。它可以是以下之一：<br>
+              -“Dijkstra”：双向Dijkstra算法。<br>
+              -“AStar”：A*算法，以到终点的直线距离 / max_speed 为启发值。<br>
+              -“BiAStar”：双向A*算法。<br>
+              -“ALT”：以路标下界导向的双向搜索，需先调用 build_landmarks 为该 weight_name 构建索引。<br>
+              -“CH”：收缩层次上的双向搜索，需先调用 build_ch 为该 weight_name 构建收缩层次。<br>
+              -“CRP”：多层覆盖图上的搜索，需先调用 build_overlay 与 customize_overlay 为该 weight_name 定制团花费。<br>
+              A*需先调用 set_node_coords 为全部节点（形心点除外）设置坐标。
+           max_speed (float): 速度上界，须满足每条边的权重不小于其两端直线距离 / max_speed，否则结果可能不是最短路。默认值为1.0。
 
         Raises:
             ValueError: 如果任何输入参数的类型或值无效：<br>
                -“source”必须是整数。<br>
                -“target”必须是整数。<br>
                -“weight_name”必须是字符串。<br>
+               -“method”必须是 POINT_TO_POINT_METHODS 之一。<br>
+               -“max_speed”必须是正数。<br>
 
         Returns:
             tuple[float, list[int]]: 最短路径到达目标节点的花费和路径。 例如：<br>
@@ -1282,8 +2037,16 @@ class CGraph:
             if weight_name is not None and not isinstance(weight_name, str):
                 raise ValueError(f"Invalid value for 'weight_name': {weight_name}. It must be either a string or None.")
 
+            # 检查 method 是否有效
+            if method not in POINT_TO_POINT_METHODS:
+                raise ValueError(f"Invalid value for 'method': {method}. It must be one of {POINT_TO_POINT_METHODS}.")
+
+            # 检查 max_speed 是否为正数
+            if not isinstance(max_speed, (int, float)) or max_speed <= 0:
+                raise ValueError(f"Invalid value for 'max_speed': {max_speed}. It must be a positive number.")
+
         if weight_name is None:
             weight_name = ""
-        result = self.graph.shortest_path_all(source, target, weight_name)
+        result = self.graph.shortest_path_all(source, target, weight_name, method, float(max_speed))
 
         return result
@@ -17,6 +17,13 @@ int main() {
 PYBIND11_MODULE(graphwork, m) {
 	m.doc() = "module using pybind11";
 
+	// 是否以紧凑模式（float32 权重与花费）编译
+#ifdef GRAPHWORK_COMPACT
+	m.attr("compact_mode") = true;
+#else
+	m.attr("compact_mode") = false;
+#endif
+
 	py::bind_vector<std::vector<int>>(m, "ListInt", py::module_local(false))
 		.def("__repr__", [](const std::vector<int>& vec) {
 		std::string repr = "[";
@@ -84,6 +91,10 @@ PYBIND11_MODULE(graphwork, m) {
 		.def("get_graph_info", &CGraph::get_graph_info)
 
 
+		// 获取内存用量
+		.def("get_memory_usage", &CGraph::get_memory_usage)
+
+
 		// 获取节点信息
 		.def("get_node_info", &CGraph::get_node_info,
 			py::arg("id"))
@@ -105,6 +116,10 @@ PYBIND11_MODULE(graphwork, m) {
 		.def("add_edges", &CGraph::add_edges,
 			py::arg("edges"))
 
+		.def("add_edges_from_arrays", &CGraph::add_edges_from_arrays,
+			py::arg("u"),
+			py::arg("v"))
+
 
 		// 删边
 		.def("remove_edge", &CGraph::remove_edge,
@@ -115,6 +130,13 @@ PYBIND11_MODULE(graphwork, m) {
 			py::arg("edges"))
 
 
+		// 节点坐标
+		.def("set_node_coords", &CGraph::set_node_coords,
+			py::arg("nodes"),
+			py::arg("x"),
+			py::arg("y"))
+
+
 		// 设置形心点
 		.def("set_centroid", py::overload_cast<int>(&CGraph::set_centroid),
 			py::arg("node"))
@@ -126,6 +148,96 @@ PYBIND11_MODULE(graphwork, m) {
 		.def(py::init<>())
 
 
+		// 构建CSR快照
+		.def("freeze", &GraphAlgorithms::freeze)
+
+		.def("compact", &GraphAlgorithms::compact,
+			py::arg("wait") = false)
+
+
+		// 权重列缓存
+		.def("prepare_weight", &GraphAlgorithms::prepare_weight,
+			py::arg("weight_name"))
+
+		.def("drop_weight", &GraphAlgorithms::drop_weight,
+			py::arg("weight_name"))
+
+
+		// 节点重排
+		.def("reorder_nodes", &GraphAlgorithms::reorder_nodes,
+			py::arg("method") = "RCM")
+
+
+		// 空间索引查询
+		.def("nearest_nodes", &GraphAlgorithms::nearest_nodes,
+			py::arg("x"),
+			py::arg("y"),
+			py::arg("k") = 1,
+			py::arg("num_thread") = 1)
+
+		.def("nearest_edges", &GraphAlgorithms::nearest_edges,
+			py::arg("x"),
+			py::arg("y"),
+			py::arg("radius"),
+			py::arg("num_thread") = 1)
+
+
+		// 度为 2 的链收缩
+		.def("contract_chains", &GraphAlgorithms::contract_chains,
+			py::arg("enable") = true)
+
+
+		// ALT 路标索引
+		.def("build_landmarks", &GraphAlgorithms::build_landmarks,
+			py::arg("weight_name") = "",
+			py::arg("num_landmarks") = 16,
+			py::arg("selection") = "avoid",
+			py::arg("num_thread") = 1)
+
+
+		// 收缩层次
+		.def("build_ch", &GraphAlgorithms::build_ch,
+			py::arg("weight_name") = "")
+
+
+		// CRP 多层覆盖图
+		.def("build_overlay", &GraphAlgorithms::build_overlay,
+			py::arg("cell_size") = 128,
+			py::arg("num_levels") = 4,
+			py::arg("fanout") = 8)
+
+		.def("customize_overlay", &GraphAlgorithms::customize_overlay,
+			py::arg("weight_name") = "",
+			py::arg("num_thread") = 1)
+
+
+		// 批量原地修改边权重
+		.def("update_edge_weights", &GraphAlgorithms::update_edge_weights,
+			py::arg("u"),
+			py::arg("v"),
+			py::arg("values"),
+			py::arg("field"))
+
+
+		// 图像文件
+		.def("save", &GraphAlgorithms::save,
+			py::arg("path"))
+
+		.def("load", &GraphAlgorithms::load,
+			py::arg("path"))
+
+
+		// 共享内存
+		.def("publish_shared", &GraphAlgorithms::publish_shared,
+			py::arg("name"))
+
+		.def("attach_shared", &GraphAlgorithms::attach_shared,
+			py::arg("name"))
+
+		.def_static("unlink_shared", &GraphAlgorithms::unlink_shared,
+			py::arg("name"))
+
+
 		// 多源最短路径
 		.def("multi_source_cost", &GraphAlgorithms::multi_source_cost,
 			py::arg("start_nodes"),
@@ -204,6 +316,15 @@ PYBIND11_MODULE(graphwork, m) {
 			py::arg("num_thread") = 1)
 
 
+		.def("multi_single_source_cost_targets", &GraphAlgorithms::multi_single_source_cost_targets,
+			py::arg("start_nodes"),
+			py::arg("targets"),
+			py::arg("method") = "Dijkstra",
+			py::arg("cut_off") = numeric_limits<double>::infinity(),
+			py::arg("weight_name") = "",
+			py::arg("num_thread") = 1)
+
+
 		// 多个多源最短路径
 		.def("multi_multi_source_cost", &GraphAlgorithms::multi_multi_source_cost,
 			py::arg("start_nodes"),
@@ -234,6 +355,15 @@ PYBIND11_MODULE(graphwork, m) {
 			py::arg("num_thread") = 1)
 
 
+		.def("multi_multi_source_cost_targets", &GraphAlgorithms::multi_multi_source_cost_targets,
+			py::arg("start_nodes"),
+			py::arg("targets"),
+			py::arg("method") = "Dijkstra",
+			py::arg("cut_off") = numeric_limits<double>::infinity(),
+			py::arg("weight_name") = "",
+			py::arg("num_thread") = 1)
+
+
 		// 花费矩阵
 		.def("cost_matrix_to_numpy", &GraphAlgorithms::cost_matrix_to_numpy,
 			py::arg("starts"),
@@ -259,26 +389,33 @@ PYBIND11_MODULE(graphwork, m) {
 			py::arg("source"),
 			py::arg("target"),
 			py::arg("num"),
-			py::arg("weight_name") = "")
+			py::arg("weight_name") = "",
+			py::arg("method") = "Dijkstra")
 
 
 		// 单个OD对最短花费和路径
 		.def("shortest_path_cost", &GraphAlgorithms::shortest_path_cost,
 			py::arg("source"),
 			py::arg("target"),
-			py::arg("weight_name") = "")
+			py::arg("weight_name") = "",
+			py::arg("method") = "Dijkstra",
+			py::arg("max_speed") = 1.0)
 
 
 		.def("shortest_path_path", &GraphAlgorithms::shortest_path_path,
 			py::arg("source"),
 			py::arg("target"),
-			py::arg("weight_name") = "")
+			py::arg("weight_name") = "",
+			py::arg("method") = "Dijkstra",
+			py::arg("max_speed") = 1.0)
 
 
 		.def("shortest_path_all", &GraphAlgorithms::shortest_path_all,
 			py::arg("source"),
 			py::arg("target"),
-			py::arg("weight_name") = "")
+			py::arg("weight_name") = "",
+			py::arg("method") = "Dijkstra",
+			py::arg("max_speed") = 1.0)
 
 
 		.def("process", [](GraphAlgorithms& self, py::object df) { // 注意这里传入self引用